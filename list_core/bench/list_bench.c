@@ -0,0 +1,549 @@
+// list_bench.c - Benchmark harness that measures the cost of the basic
+// operations of list_core over a range of list sizes
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "list_root.h"
+#include "list_traversal.h"
+
+/**
+ * @brief Largest list size benchmarked when none is given on the command
+ * line.
+ */
+#define BENCH_DEFAULT_MAX_SIZE 10000000
+
+/**
+ * @brief Number of list elements that repeated read-only scenarios (search,
+ * count, sum) aim to visit in total at each size, so that small lists are
+ * traversed many times and large ones only once or a few times.
+ */
+#define BENCH_ELEMENTS_PER_RUN 10000000L
+
+/**
+ * @brief Per-scenario state shared by the setup, run and teardown routines.
+ */
+typedef struct _tagBENCH_CONTEXT {
+  int nSize;                  // Number of elements in the list
+  void** ppvData;             // Data pointers for elements 0 to nSize - 1
+  LPPOSITION lpHead;          // Head of the list under test, if any
+  LPPOSITION lpCurrent;       // Element the scenario operates on
+  LPLIST_ROOT lpRoot;         // Root of the list under test, if any
+  long nOps;                  // Number of operations the run performed
+  long nSink;                 // Defeats elimination of read-only work
+} BENCH_CONTEXT, *LPBENCH_CONTEXT;
+
+typedef void (*LPBENCH_ROUTINE)(LPBENCH_CONTEXT lpContext);
+
+/**
+ * @brief Describes one benchmark scenario.  Only the run routine is timed.
+ */
+typedef struct _tagBENCH_SCENARIO {
+  const char* pszName;
+  int nMaxSize;               // Sizes above this are skipped; 0 for no limit
+  LPBENCH_ROUTINE lpfnSetup;
+  LPBENCH_ROUTINE lpfnRun;
+  LPBENCH_ROUTINE lpfnTeardown;
+} BENCH_SCENARIO, *LPBENCH_SCENARIO;
+
+/**
+ * @brief Measurements of one run, passed from the child process that made
+ * them back to the harness.
+ */
+typedef struct _tagBENCH_RESULT {
+  long nOps;
+  long long nElapsed;         // Nanoseconds spent in the run routine
+  long nAllocations;
+  long nAllocatedBytes;
+  long nFrees;
+  long nSink;
+} BENCH_RESULT, *LPBENCH_RESULT;
+
+//////////////////////////////////////////////////////////////////////////////
+// Allocation counters
+//
+// The benchmark is linked with -Wl,--wrap for each of the allocation
+// functions, so that every allocation made by the library is counted on its
+// way to the C runtime.
+
+void* __real_malloc(size_t nSize);
+void* __real_calloc(size_t nCount, size_t nSize);
+void* __real_realloc(void* pvBlock, size_t nSize);
+int __real_posix_memalign(void** ppvBlock, size_t nAlignment, size_t nSize);
+void __real_free(void* pvBlock);
+
+static long g_nAllocations = 0;
+static long g_nAllocatedBytes = 0;
+static long g_nFrees = 0;
+
+static void CountAllocation(size_t nSize) {
+  __atomic_fetch_add(&g_nAllocations, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&g_nAllocatedBytes, (long) nSize, __ATOMIC_RELAXED);
+}
+
+void* __wrap_malloc(size_t nSize) {
+  CountAllocation(nSize);
+  return __real_malloc(nSize);
+}
+
+void* __wrap_calloc(size_t nCount, size_t nSize) {
+  CountAllocation(nCount * nSize);
+  return __real_calloc(nCount, nSize);
+}
+
+void* __wrap_realloc(void* pvBlock, size_t nSize) {
+  CountAllocation(nSize);
+  return __real_realloc(pvBlock, nSize);
+}
+
+int __wrap_posix_memalign(void** ppvBlock, size_t nAlignment, size_t nSize) {
+  CountAllocation(nSize);
+  return __real_posix_memalign(ppvBlock, nAlignment, nSize);
+}
+
+void __wrap_free(void* pvBlock) {
+  if (pvBlock != NULL) {
+    __atomic_fetch_add(&g_nFrees, 1, __ATOMIC_RELAXED);
+  }
+  __real_free(pvBlock);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Callbacks handed to the library
+
+static BOOL CompareValues(void* pvSearchKey, void* pvData) {
+  return *((int*) pvSearchKey) == *((int*) pvData);
+}
+
+static int GetValue(void* pvData) {
+  return *((int*) pvData);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Helpers
+
+static long GetReadRepetitions(int nSize) {
+  long nReps = BENCH_ELEMENTS_PER_RUN / nSize;
+  return nReps < 1 ? 1 : nReps;
+}
+
+static long long GetNanoseconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void BuildList(LPBENCH_CONTEXT lpContext) {
+  CreateListFromArray(&(lpContext->lpHead), lpContext->ppvData,
+      lpContext->nSize);
+  lpContext->lpCurrent = lpContext->lpHead;
+}
+
+static void BuildScatteredList(LPBENCH_CONTEXT lpContext) {
+  BuildList(lpContext);
+
+  /* Relink the nodes in a random order, so that consecutive elements, and
+   the data they point to, lie far apart in memory.  Once the list outgrows
+   the last-level cache, each step of a walk then misses it, and the hardware
+   prefetcher has no stride to follow. */
+  int nSize = lpContext->nSize;
+  LPPOSITION* ppNodes = (LPPOSITION*) malloc(nSize * sizeof(LPPOSITION));
+  if (ppNodes == NULL) {
+    return;   // Fall back to the list in allocation order
+  }
+
+  LPPOSITION lpElement = lpContext->lpHead;
+  for (int i = 0; i < nSize; i++, lpElement = lpElement->pNext) {
+    ppNodes[i] = lpElement;
+  }
+
+  unsigned int nState = 0x9E3779B9U;
+  for (int i = nSize - 1; i > 0; i--) {
+    nState ^= nState << 13;
+    nState ^= nState >> 17;
+    nState ^= nState << 5;
+    int j = (int) (nState % (unsigned int) (i + 1));
+    LPPOSITION lpSwap = ppNodes[i];
+    ppNodes[i] = ppNodes[j];
+    ppNodes[j] = lpSwap;
+  }
+
+  for (int i = 0; i < nSize; i++) {
+    ppNodes[i]->pPrev = i > 0 ? ppNodes[i - 1] : NULL;
+    ppNodes[i]->pNext = i < nSize - 1 ? ppNodes[i + 1] : NULL;
+  }
+
+  lpContext->lpHead = ppNodes[0];
+  lpContext->lpCurrent = lpContext->lpHead;
+
+  free(ppNodes);
+}
+
+static void ClearCurrentList(LPBENCH_CONTEXT lpContext) {
+  if (lpContext->lpCurrent != NULL) {
+    ClearList(&(lpContext->lpCurrent), DeallocateNothing);
+  }
+  lpContext->lpHead = NULL;
+}
+
+static void WaitForClears(LPBENCH_CONTEXT lpContext) {
+  WaitForAsyncClears();
+  ClearCurrentList(lpContext);
+}
+
+static void DestroyRoot(LPBENCH_CONTEXT lpContext) {
+  DestroyListRoot(&(lpContext->lpRoot), DeallocateNothing);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Scenarios
+
+static void RunAppend(LPBENCH_CONTEXT lpContext) {
+  lpContext->lpCurrent = NULL;
+  for (int i = 0; i < lpContext->nSize; i++) {
+    AddElement(&(lpContext->lpCurrent), lpContext->ppvData[i]);
+  }
+  lpContext->nOps = lpContext->nSize;
+}
+
+static void RunAppendTailFromHead(LPBENCH_CONTEXT lpContext) {
+  lpContext->lpHead = NULL;
+  for (int i = 0; i < lpContext->nSize; i++) {
+    /* Start from the head each time, as an application that only keeps
+     track of the head must; AddElementToTail then walks the whole list. */
+    LPPOSITION lpElement = lpContext->lpHead;
+    AddElementToTail(&lpElement, lpContext->ppvData[i]);
+    if (lpContext->lpHead == NULL) {
+      lpContext->lpHead = lpElement;
+    }
+  }
+  lpContext->lpCurrent = lpContext->lpHead;
+  lpContext->nOps = lpContext->nSize;
+}
+
+static void RunBulkAppend(LPBENCH_CONTEXT lpContext) {
+  BuildList(lpContext);
+  lpContext->nOps = lpContext->nSize;
+}
+
+static void SetupRoot(LPBENCH_CONTEXT lpContext) {
+  CreateListRoot(&(lpContext->lpRoot));
+}
+
+static void SetupPooledRoot(LPBENCH_CONTEXT lpContext) {
+  CreatePooledListRoot(&(lpContext->lpRoot), 0);
+}
+
+static void RunRootAppend(LPBENCH_CONTEXT lpContext) {
+  for (int i = 0; i < lpContext->nSize; i++) {
+    AddRootElementToTail(lpContext->lpRoot, lpContext->ppvData[i]);
+  }
+  lpContext->nOps = lpContext->nSize;
+}
+
+static void RunFind(LPBENCH_CONTEXT lpContext) {
+  long nReps = GetReadRepetitions(lpContext->nSize);
+  for (long i = 0; i < nReps; i++) {
+    /* Spread the keys over the whole list, so that on average half of it is
+     walked per lookup. */
+    int* pnKey = (int*) lpContext->ppvData[(i * 7919) % lpContext->nSize];
+    LPPOSITION lpFound = FindElement(lpContext->lpHead, pnKey,
+        CompareValues);
+    lpContext->nSink += lpFound != NULL;
+  }
+  lpContext->nOps = nReps;
+}
+
+static void RunCount(LPBENCH_CONTEXT lpContext) {
+  long nReps = GetReadRepetitions(lpContext->nSize);
+  for (long i = 0; i < nReps; i++) {
+    lpContext->nSink += GetElementCount(lpContext->lpHead);
+  }
+  lpContext->nOps = nReps;
+}
+
+static void RunSum(LPBENCH_CONTEXT lpContext) {
+  long nReps = GetReadRepetitions(lpContext->nSize);
+  for (long i = 0; i < nReps; i++) {
+    lpContext->nSink += SumElements(lpContext->lpHead, GetValue);
+  }
+  lpContext->nOps = nReps;
+}
+
+static void RunRemove(LPBENCH_CONTEXT lpContext) {
+  long nOps = 0;
+  while (lpContext->lpCurrent != NULL) {
+    RemoveElement(&(lpContext->lpCurrent), DeallocateNothing);
+    nOps++;
+  }
+  lpContext->lpHead = NULL;
+  lpContext->nOps = nOps;
+}
+
+static void SetupRemoveTail(LPBENCH_CONTEXT lpContext) {
+  BuildList(lpContext);
+  MoveToTailPosition(&(lpContext->lpCurrent));
+}
+
+static void SetupRemoveMiddle(LPBENCH_CONTEXT lpContext) {
+  BuildList(lpContext);
+  for (int i = 0; i < lpContext->nSize / 4; i++) {
+    lpContext->lpCurrent = lpContext->lpCurrent->pNext;
+  }
+}
+
+static void RunRemoveMiddle(LPBENCH_CONTEXT lpContext) {
+  /* Remove the middle half of the list; each removal moves the current
+   element pointer on to the next element. */
+  int nCount = lpContext->nSize / 2;
+  for (int i = 0; i < nCount; i++) {
+    RemoveElement(&(lpContext->lpCurrent), DeallocateNothing);
+  }
+  lpContext->nOps = nCount;
+}
+
+static void RunClear(LPBENCH_CONTEXT lpContext) {
+  ClearList(&(lpContext->lpCurrent), DeallocateNothing);
+  lpContext->lpHead = NULL;
+  lpContext->nOps = lpContext->nSize;
+}
+
+static void RunClearAsync(LPBENCH_CONTEXT lpContext) {
+  /* Only the time the caller is held up is measured; the nodes are freed
+   by the background thread while the teardown waits for it. */
+  ClearListAsync(&(lpContext->lpCurrent), DeallocateNothing);
+  lpContext->lpHead = NULL;
+  lpContext->nOps = lpContext->nSize;
+}
+
+static BENCH_SCENARIO g_aScenarios[] = {
+  { "append", 0, NULL, RunAppend, ClearCurrentList },
+  { "append_tail_from_head", 10000, NULL, RunAppendTailFromHead,
+      ClearCurrentList },
+  { "bulk_append", 0, NULL, RunBulkAppend, ClearCurrentList },
+  { "root_append", 0, SetupRoot, RunRootAppend, DestroyRoot },
+  { "pooled_root_append", 0, SetupPooledRoot, RunRootAppend, DestroyRoot },
+  { "find", 0, BuildList, RunFind, ClearCurrentList },
+  { "count", 0, BuildList, RunCount, ClearCurrentList },
+  { "sum", 0, BuildList, RunSum, ClearCurrentList },
+  { "remove_head", 0, BuildList, RunRemove, ClearCurrentList },
+  { "remove_tail", 0, SetupRemoveTail, RunRemove, ClearCurrentList },
+  { "remove_middle", 0, SetupRemoveMiddle, RunRemoveMiddle,
+      ClearCurrentList },
+  { "clear", 0, BuildList, RunClear, ClearCurrentList },
+  { "clear_async", 0, BuildList, RunClearAsync, WaitForClears },
+  { "find_scattered", 0, BuildScatteredList, RunFind, ClearCurrentList },
+  { "count_scattered", 0, BuildScatteredList, RunCount, ClearCurrentList },
+  { "sum_scattered", 0, BuildScatteredList, RunSum, ClearCurrentList },
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// MeasureScenario function - Sets up, runs and tears down one scenario at one
+// size, timing the run and counting the allocations it makes.
+
+static void MeasureScenario(LPBENCH_SCENARIO lpScenario, void** ppvData,
+    int nSize, LPBENCH_RESULT lpResult) {
+  BENCH_CONTEXT context;
+  memset(&context, 0, sizeof(BENCH_CONTEXT));
+  context.nSize = nSize;
+  context.ppvData = ppvData;
+
+  if (lpScenario->lpfnSetup != NULL) {
+    lpScenario->lpfnSetup(&context);
+  }
+
+  long nAllocations = __atomic_load_n(&g_nAllocations, __ATOMIC_RELAXED);
+  long nAllocatedBytes = __atomic_load_n(&g_nAllocatedBytes,
+      __ATOMIC_RELAXED);
+  long nFrees = __atomic_load_n(&g_nFrees, __ATOMIC_RELAXED);
+  long long nStart = GetNanoseconds();
+
+  lpScenario->lpfnRun(&context);
+
+  lpResult->nElapsed = GetNanoseconds() - nStart;
+  lpResult->nAllocations = __atomic_load_n(&g_nAllocations,
+      __ATOMIC_RELAXED) - nAllocations;
+  lpResult->nAllocatedBytes = __atomic_load_n(&g_nAllocatedBytes,
+      __ATOMIC_RELAXED) - nAllocatedBytes;
+  lpResult->nFrees = __atomic_load_n(&g_nFrees, __ATOMIC_RELAXED) - nFrees;
+  lpResult->nOps = context.nOps;
+  lpResult->nSink = context.nSink;
+
+  if (lpScenario->lpfnTeardown != NULL) {
+    lpScenario->lpfnTeardown(&context);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RunScenario function - Runs one scenario at one size, and writes its
+// results to standard output as a single line of JSON.  Each run takes place
+// in a child process of its own, so that the peak resident set size that is
+// reported belongs to that run alone, and no run inherits the heap left
+// behind by the previous one.
+
+static void RunScenario(LPBENCH_SCENARIO lpScenario, void** ppvData,
+    int nSize) {
+  if (lpScenario->nMaxSize > 0 && nSize > lpScenario->nMaxSize) {
+    printf("{\"benchmark\":\"%s\",\"size\":%d,\"skipped\":true}\n",
+        lpScenario->pszName, nSize);
+    return;
+  }
+
+  int afd[2];
+  if (pipe(afd) != 0) {
+    perror("list_bench: pipe");
+    return;
+  }
+
+  fflush(stdout);   // The child must not inherit buffered output
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("list_bench: fork");
+    close(afd[0]);
+    close(afd[1]);
+    return;
+  }
+
+  if (pid == 0) {
+    BENCH_RESULT result;
+    memset(&result, 0, sizeof(BENCH_RESULT));
+
+    close(afd[0]);
+    MeasureScenario(lpScenario, ppvData, nSize, &result);
+    ssize_t nWritten = write(afd[1], &result, sizeof(BENCH_RESULT));
+    _exit(nWritten == (ssize_t) sizeof(BENCH_RESULT) ? OK : 1);
+  }
+
+  close(afd[1]);
+
+  BENCH_RESULT result;
+  ssize_t nRead = 0;
+  while ((nRead = read(afd[0], &result, sizeof(BENCH_RESULT))) < 0
+      && errno == EINTR) {
+    // Interrupted; try again
+  }
+  close(afd[0]);
+
+  int nStatus = 0;
+  struct rusage usage;
+  memset(&usage, 0, sizeof(struct rusage));
+  while (wait4(pid, &nStatus, 0, &usage) < 0 && errno == EINTR) {
+    // Interrupted; try again
+  }
+
+  if (nRead != (ssize_t) sizeof(BENCH_RESULT) || !WIFEXITED(nStatus)
+      || WEXITSTATUS(nStatus) != OK) {
+    printf("{\"benchmark\":\"%s\",\"size\":%d,\"failed\":true}\n",
+        lpScenario->pszName, nSize);
+    fflush(stdout);
+    return;
+  }
+
+  printf("{\"benchmark\":\"%s\",\"size\":%d,\"ops\":%ld,\"ns_total\":%lld,"
+      "\"ns_per_op\":%.2f,\"allocs\":%ld,\"alloc_bytes\":%ld,\"frees\":%ld,"
+      "\"peak_rss_kb\":%ld,\"prefetch_distance\":%d,\"sink\":%ld}\n",
+      lpScenario->pszName, nSize,
+      result.nOps, result.nElapsed,
+      result.nOps > 0 ? (double) result.nElapsed / result.nOps : 0.0,
+      result.nAllocations, result.nAllocatedBytes, result.nFrees,
+      usage.ru_maxrss, LIST_CORE_PREFETCH_DISTANCE, result.nSink);
+  fflush(stdout);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PrintUsage function
+
+static void PrintUsage(const char* pszProgram) {
+  fprintf(stderr, "Usage: %s [-m max_size] [-b benchmark]\n"
+      "  -m max_size   largest list size to run, 10 to 10^7 in powers of ten"
+      " (default %d)\n"
+      "  -b benchmark  run only the named benchmark\n"
+      "Results are written to standard output, one JSON object per line.\n"
+      "Each run takes place in a child process of its own; peak_rss_kb is\n"
+      "that process's high-water mark, including the data array that it\n"
+      "shares with the harness.\n",
+      pszProgram, BENCH_DEFAULT_MAX_SIZE);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// main function
+
+int main(int argc, char* argv[]) {
+  int nMaxSize = BENCH_DEFAULT_MAX_SIZE;
+  const char* pszOnly = NULL;
+  int nOption = 0;
+
+  while ((nOption = getopt(argc, argv, "m:b:h")) != -1) {
+    switch (nOption) {
+      case 'm':
+        nMaxSize = atoi(optarg);
+        break;
+
+      case 'b':
+        pszOnly = optarg;
+        break;
+
+      default:
+        PrintUsage(argv[0]);
+        return nOption == 'h' ? OK : ERROR;
+    }
+  }
+
+  if (nMaxSize < 10) {
+    PrintUsage(argv[0]);
+    return ERROR;
+  }
+
+  int* pnValues = (int*) malloc(nMaxSize * sizeof(int));
+  void** ppvData = (void**) malloc(nMaxSize * sizeof(void*));
+  if (pnValues == NULL || ppvData == NULL) {
+    fprintf(stderr, "list_bench: failed to allocate %d data items.\n",
+        nMaxSize);
+    return ERROR;
+  }
+
+  for (int i = 0; i < nMaxSize; i++) {
+    pnValues[i] = i;
+    ppvData[i] = &(pnValues[i]);
+  }
+
+  int nScenarioCount = (int) (sizeof(g_aScenarios) / sizeof(BENCH_SCENARIO));
+
+  for (int i = 0; i < nScenarioCount; i++) {
+    if (pszOnly != NULL && strcmp(pszOnly, g_aScenarios[i].pszName) != 0) {
+      continue;
+    }
+
+    for (long nSize = 10; nSize <= nMaxSize; nSize *= 10) {
+      RunScenario(&(g_aScenarios[i]), ppvData, (int) nSize);
+    }
+  }
+
+  free(ppvData);
+  free(pnValues);
+
+  return OK;
+}
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,244 @@
+// chunked_list.h - Defines the interface to the CHUNKED_LIST data structure,
+// an unrolled linked list whose nodes each hold several data pointers.
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __CHUNKED_LIST_H__
+#define __CHUNKED_LIST_H__
+
+#include "list_core.h"
+
+/**
+ * @brief Number of data pointers held by each chunk.  The default value makes
+ * a chunk exactly two 64-byte cache lines long on LP64 platforms.
+ */
+#ifndef LIST_CHUNK_CAPACITY
+#define LIST_CHUNK_CAPACITY 13
+#endif //LIST_CHUNK_CAPACITY
+
+/**
+ * @brief Alignment, in bytes, of each chunk in memory.
+ */
+#ifndef LIST_CHUNK_ALIGNMENT
+#define LIST_CHUNK_ALIGNMENT 64
+#endif //LIST_CHUNK_ALIGNMENT
+
+/**
+ * @brief Structure that encapsulates a node of an unrolled linked list.
+ *
+ * Each chunk holds up to LIST_CHUNK_CAPACITY data pointers, packed at the
+ * start of its apvData array, in list order.
+ */
+typedef struct _tagLIST_CHUNK {
+  struct _tagLIST_CHUNK* pPrev;
+  struct _tagLIST_CHUNK* pNext;
+  int nCount;
+  void* apvData[LIST_CHUNK_CAPACITY];
+} LIST_CHUNK, *LPLIST_CHUNK;
+
+/**
+ * @brief Structure that serves as the root of an unrolled linked list.
+ *
+ * Storing several data pointers per node means that a sequential scan touches
+ * several times fewer cache lines than a scan of a list of POSITION nodes, and
+ * that only one allocation is needed per LIST_CHUNK_CAPACITY elements.  The
+ * same callback types as the POSITION-based functions are used throughout.
+ */
+typedef struct _tagCHUNKED_LIST {
+  LPLIST_CHUNK pHead;
+  LPLIST_CHUNK pTail;
+  int nCount;
+} CHUNKED_LIST, *LPCHUNKED_LIST, **LPPCHUNKED_LIST;
+
+/**
+ * @name AddChunkedElement
+ * @brief Adds a new element to the tail of the list.
+ * @param lpList Address of the list.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @return TRUE if the element was added; FALSE otherwise.
+ */
+BOOL AddChunkedElement(LPCHUNKED_LIST lpList, void* pvData);
+
+/**
+ * @name ClearChunkedList
+ * @brief Removes and deallocates all the elements from the list, leaving the
+ * list itself intact and empty.
+ * @param lpList Address of the list.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each element
+ * from the heap.  Supplied by the application.
+ */
+void ClearChunkedList(LPCHUNKED_LIST lpList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name CreateChunkedList
+ * @brief Allocates a new, empty unrolled list.
+ * @param lppList Address of a pointer that will receive the address of the
+ * new list.  The pointer is set to NULL if the allocation fails.
+ */
+void CreateChunkedList(LPPCHUNKED_LIST lppList);
+
+/**
+ * @name CreateChunkedListFromPositions
+ * @brief Allocates a new unrolled list that refers to the same data, in the
+ * same order, as an existing list of POSITION nodes.
+ * @param lppList Address of a pointer that will receive the address of the
+ * new list.  The pointer is set to NULL if the allocation fails.
+ * @param lpElement Address of any element of the existing list.  May be NULL,
+ * in which case the new list is empty.
+ * @remarks The existing list is not altered.  Both lists refer to the same
+ * data afterward, so only one of them should deallocate the data.
+ */
+void CreateChunkedListFromPositions(LPPCHUNKED_LIST lppList,
+    LPPOSITION lpElement);
+
+/**
+ * @name DestroyChunkedList
+ * @brief Removes all the elements of the list and then deallocates the list.
+ * @param lppList Address of a pointer to the list to be destroyed.  This
+ * pointer is reset to NULL.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each element
+ * from the heap.  Supplied by the application.
+ */
+void DestroyChunkedList(LPPCHUNKED_LIST lppList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name DoForEachChunkedElement
+ * @brief Executes an action for each of the elements of the list, in order.
+ * @param lpList Address of the list.
+ * @param lpfnAction Address of a function that specifies the code to run for
+ * each element of the list.
+ */
+void DoForEachChunkedElement(LPCHUNKED_LIST lpList,
+    LPACTION_ROUTINE lpfnAction);
+
+/**
+ * @name FindChunkedElement
+ * @brief Locates the first element whose data matches the search key
+ * according to the specified comparison routine.
+ * @param lpList Address of the list.
+ * @param pvSearchKey Address of data to serve as a lookup key.
+ * @param lpfnCompare User-specified routine that determines whether a given
+ * element's data matches the key.
+ * @return Address of the matching element's data, or NULL if not found.
+ */
+void* FindChunkedElement(LPCHUNKED_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompare);
+
+/**
+ * @name FindChunkedElementWhere
+ * @brief Locates the first element for which the specified predicate
+ * function evaluates to TRUE.
+ * @param lpList Address of the list.
+ * @param lpfnPredicate Address of a user-specified predicate routine.
+ * @return Address of the matching element's data, or NULL if not found.
+ */
+void* FindChunkedElementWhere(LPCHUNKED_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate);
+
+/**
+ * @name GetChunkedElementCount
+ * @brief Gets the count of the elements in the list.
+ * @param lpList Address of the list.
+ * @return Count of elements in the list.
+ * @remarks This operation takes constant time.
+ */
+int GetChunkedElementCount(LPCHUNKED_LIST lpList);
+
+/**
+ * @name GetChunkedElementCountWhere
+ * @brief Gets the count of all elements in the list for which a user-specified
+ * predicate function returns TRUE.
+ * @param lpList Address of the list.
+ * @param lpfnPredicate Address of a user-specified predicate function.
+ * @return Count of all the list's elements for which the predicate evaluates
+ * to TRUE.
+ */
+int GetChunkedElementCountWhere(LPCHUNKED_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate);
+
+/**
+ * @name RemoveChunkedElementWhere
+ * @brief Removes all elements from the list whose data match the search key
+ * according to the specified comparison routine.
+ * @param lpList Address of the list.
+ * @param pvSearchKey Address of data to be used as a key in the search for
+ * which elements to delete.
+ * @param lpfnCompareFunc Address of a callback provided by the application
+ * that determines whether an element's data matches the key.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data each
+ * element refers to from the heap.
+ * @return Number of elements that were removed from the list.
+ * @remarks The list is traversed only once.  The surviving elements are packed
+ * toward the head as the traversal proceeds, and chunks that are left empty
+ * are freed, so the list stays dense.
+ */
+int RemoveChunkedElementWhere(LPCHUNKED_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareFunc, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name RemoveChunkedElementWherePredicate
+ * @brief Removes all elements from the list for which the specified predicate
+ * function evaluates to TRUE.
+ * @param lpList Address of the list.
+ * @param lpfnPredicate Address of a user-specified predicate routine.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data each
+ * element refers to from the heap.
+ * @return Number of elements that were removed from the list.
+ * @remarks See RemoveChunkedElementWhere.
+ */
+int RemoveChunkedElementWherePredicate(LPCHUNKED_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name SumChunkedElements
+ * @brief Calculates the sum of a sequence of quantities, which itself is
+ * computed from the data elements referred to by the elements of this list.
+ * @param lpList Address of the list.
+ * @param lpfnSumRoutine Address of a callback that calculates each term
+ * of the summation, given the address of the data referenced by the current
+ * element.
+ * @return Result of the summation, or -1 if an error occurred.
+ */
+int SumChunkedElements(LPCHUNKED_LIST lpList,
+    LPSUMMATION_ROUTINE lpfnSumRoutine);
+
+/**
+ * @name SumChunkedElementsWhere
+ * @brief Calculates the sum of a sequence of quantities, including only those
+ * elements whose data match the search key according to the compare routine.
+ * @param lpList Address of the list.
+ * @param lpfnSumRoutine Address of a callback that calculates each term
+ * of the summation.
+ * @param pvSearchKey Address of user data that is to be utilized as a search
+ * key to check whether elements meet the criteria for being included in the
+ * summation.
+ * @param lpfnCompareRoutine Address of a callback that provides the criteria
+ * by which elements are to be included or excluded from the summation.
+ * @return Result of the summation, or -1 if an error occurred.  Returns zero
+ * if nothing is included in the sum.
+ */
+int SumChunkedElementsWhere(LPCHUNKED_LIST lpList,
+    LPSUMMATION_ROUTINE lpfnSumRoutine, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareRoutine);
+
+#endif //__CHUNKED_LIST_H__
@@ -0,0 +1,191 @@
+// concurrent_list.h - Defines the interface to the CONCURRENT_LIST data
+// structure, a linked list that may be used from several threads at once.
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __CONCURRENT_LIST_H__
+#define __CONCURRENT_LIST_H__
+
+#include <pthread.h>
+
+#include "list_core.h"
+#include "list_root.h"
+
+/**
+ * @brief Number of stripes used when the caller does not specify a count.
+ */
+#ifndef CONCURRENT_LIST_DEFAULT_STRIPES
+#define CONCURRENT_LIST_DEFAULT_STRIPES 16
+#endif //CONCURRENT_LIST_DEFAULT_STRIPES
+
+/**
+ * @brief One stripe of a CONCURRENT_LIST: a sub-list guarded by its own
+ * reader-writer lock.  Each stripe occupies its own cache line(s), so that
+ * threads working on different stripes do not contend on the same line.
+ */
+typedef struct _tagCONCURRENT_STRIPE {
+  pthread_rwlock_t lock;
+  LPLIST_ROOT lpRoot;
+} __attribute__((aligned(64))) CONCURRENT_STRIPE, *LPCONCURRENT_STRIPE;
+
+/**
+ * @brief Structure that serves as the root of a linked list that is safe to
+ * use from several threads at once.
+ *
+ * The elements are spread over a fixed number of stripes.  Appends are
+ * distributed over the stripes round-robin, so that concurrent appends
+ * usually take different locks.  Searches, counts and iterations take each
+ * stripe's lock for reading in turn, so that any number of them may run at
+ * the same time, and only ever block on the one stripe that a writer is
+ * currently modifying.  Removals take each stripe's lock for writing in turn.
+ *
+ * The order of the elements within each stripe is the order in which they
+ * were added, but the list as a whole is visited stripe by stripe, so the
+ * global insertion order is not preserved.
+ */
+typedef struct _tagCONCURRENT_LIST {
+  LPCONCURRENT_STRIPE pStripes;
+  int nStripeCount;
+  int nNextStripe;            // Advanced atomically by each append
+} CONCURRENT_LIST, *LPCONCURRENT_LIST, **LPPCONCURRENT_LIST;
+
+/**
+ * @name AddConcurrentElement
+ * @brief Adds a new element to the list.
+ * @param lpList Address of the list.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @return TRUE if the element was added; FALSE otherwise.
+ * @remarks Only the lock of the stripe that receives the element is taken.
+ */
+BOOL AddConcurrentElement(LPCONCURRENT_LIST lpList, void* pvData);
+
+/**
+ * @name ClearConcurrentList
+ * @brief Removes and deallocates all the elements from the list.
+ * @param lpList Address of the list.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each node from
+ * the heap.  Supplied by the application.
+ */
+void ClearConcurrentList(LPCONCURRENT_LIST lpList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name CreateConcurrentList
+ * @brief Allocates a new, empty concurrent list.
+ * @param lppList Address of a pointer that will receive the address of the
+ * new list.  The pointer is set to NULL if the allocation fails.
+ * @param nStripeCount Number of stripes to spread the elements over.  Specify
+ * zero to use CONCURRENT_LIST_DEFAULT_STRIPES.
+ */
+void CreateConcurrentList(LPPCONCURRENT_LIST lppList, int nStripeCount);
+
+/**
+ * @name DestroyConcurrentList
+ * @brief Removes all the elements of the list and then deallocates the list.
+ * @param lppList Address of a pointer to the list to be destroyed.  This
+ * pointer is reset to NULL.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each node from
+ * the heap.  Supplied by the application.
+ * @remarks No other thread may be using the list when it is destroyed.
+ */
+void DestroyConcurrentList(LPPCONCURRENT_LIST lppList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name DoForEachConcurrentElement
+ * @brief Executes an action for each of the elements of the list.
+ * @param lpList Address of the list.
+ * @param lpfnAction Address of a function that specifies the code to run for
+ * each element of the list.
+ * @remarks The callback is run while the lock of the stripe containing the
+ * element is held for reading; it must not add elements to, or remove elements
+ * from, the same list.
+ */
+void DoForEachConcurrentElement(LPCONCURRENT_LIST lpList,
+    LPACTION_ROUTINE lpfnAction);
+
+/**
+ * @name FindConcurrentElement
+ * @brief Locates an element whose data matches the search key according to
+ * the specified comparison routine.
+ * @param lpList Address of the list.
+ * @param pvSearchKey Address of data to serve as a lookup key.
+ * @param lpfnCompare User-specified routine that determines whether a given
+ * element's data matches the key.
+ * @return Address of the matching element's data, or NULL if not found.
+ * @remarks The data, not the node, is returned, since the node may be removed
+ * by another thread as soon as the stripe's lock is released.  It is up to the
+ * application to make sure that the data itself outlives its use.
+ */
+void* FindConcurrentElement(LPCONCURRENT_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompare);
+
+/**
+ * @name FindConcurrentElementWhere
+ * @brief Locates an element for which the specified predicate function
+ * evaluates to TRUE.
+ * @param lpList Address of the list.
+ * @param lpfnPredicate Address of a user-specified predicate routine.
+ * @return Address of the matching element's data, or NULL if not found.
+ * @remarks See FindConcurrentElement.
+ */
+void* FindConcurrentElementWhere(LPCONCURRENT_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate);
+
+/**
+ * @name GetConcurrentElementCount
+ * @brief Gets the count of the elements in the list.
+ * @param lpList Address of the list.
+ * @return Count of elements in the list.  If other threads are modifying the
+ * list at the same time, the count is only a snapshot.
+ */
+int GetConcurrentElementCount(LPCONCURRENT_LIST lpList);
+
+/**
+ * @name RemoveConcurrentElementWhere
+ * @brief Removes all elements from the list whose data match the search key
+ * according to the specified comparison routine.
+ * @param lpList Address of the list.
+ * @param pvSearchKey Address of data to be used as a key in the search for
+ * which elements to delete.
+ * @param lpfnCompareFunc Address of a callback provided by the application
+ * that determines whether an element's data matches the key.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data each node
+ * refers to from the heap.
+ * @return Number of elements that were removed from the list.
+ */
+int RemoveConcurrentElementWhere(LPCONCURRENT_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareFunc, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name RemoveConcurrentElementWherePredicate
+ * @brief Removes all elements from the list for which the specified predicate
+ * function evaluates to TRUE.
+ * @param lpList Address of the list.
+ * @param lpfnPredicate Address of a user-specified predicate routine.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data each node
+ * refers to from the heap.
+ * @return Number of elements that were removed from the list.
+ */
+int RemoveConcurrentElementWherePredicate(LPCONCURRENT_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+#endif //__CONCURRENT_LIST_H__
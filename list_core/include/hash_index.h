@@ -0,0 +1,133 @@
+// hash_index.h - Defines the interface to the HASH_INDEX data structure, a
+// secondary index that maps keys to the elements of a linked list.
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __HASH_INDEX_H__
+#define __HASH_INDEX_H__
+
+#include "list_core.h"
+
+/**
+ * @brief Number of slots in the table of a newly-created, empty index.  Must
+ * be a power of two.
+ */
+#ifndef HASH_INDEX_DEFAULT_CAPACITY
+#define HASH_INDEX_DEFAULT_CAPACITY 16
+#endif //HASH_INDEX_DEFAULT_CAPACITY
+
+/**
+ * @brief Defines the signature of a callback that computes the hash code of
+ * a search key or of the data of an element.
+ * @param pvData Address of the key or of the data to be hashed.
+ * @return Hash code.  Whenever the index's comparison routine deems a key to
+ * match the data of an element, this routine must return the same hash code
+ * for both.
+ */
+typedef unsigned int (*LPHASH_ROUTINE)(void* pvData);
+
+/**
+ * @brief One slot of a HASH_INDEX.  A slot whose lpPosition member is NULL
+ * is empty.
+ */
+typedef struct _tagHASH_SLOT {
+  LPPOSITION lpPosition;
+  unsigned int nHash;
+} HASH_SLOT, *LPHASH_SLOT;
+
+/**
+ * @brief Structure that encapsulates a hash index over the elements of a
+ * linked list.
+ *
+ * The index is an open-addressed table, with linear probing, of the list's
+ * nodes, keyed by the hash code of each node's data.  Each slot remembers the
+ * hash code of its node, so that the comparison routine only runs on nodes
+ * whose hash codes match, and so that the table can be grown without hashing
+ * the data again.  The table is doubled whenever it becomes more than three-
+ * quarters full.
+ */
+typedef struct _tagHASH_INDEX {
+  LPHASH_SLOT pSlots;
+  int nCapacity;
+  int nCount;
+  LPHASH_ROUTINE lpfnHash;
+  LPCOMPARE_ROUTINE lpfnCompare;
+} HASH_INDEX, *LPHASH_INDEX, **LPPHASH_INDEX;
+
+/**
+ * @name AddHashIndexEntry
+ * @brief Adds a node to the index.
+ * @param lpIndex Address of the index.
+ * @param lpPosition Address of the node to be added.
+ * @return TRUE if the node was added; FALSE if the table could not be grown
+ * to make room for it.
+ */
+BOOL AddHashIndexEntry(LPHASH_INDEX lpIndex, LPPOSITION lpPosition);
+
+/**
+ * @name ClearHashIndex
+ * @brief Removes all the nodes from the index.  The nodes themselves are not
+ * affected.
+ * @param lpIndex Address of the index.
+ */
+void ClearHashIndex(LPHASH_INDEX lpIndex);
+
+/**
+ * @name CreateHashIndex
+ * @brief Allocates a new, empty hash index.
+ * @param lppIndex Address of a pointer that will receive the address of the
+ * new index.  The pointer is set to NULL if the allocation fails.
+ * @param lpfnHash Address of the routine that hashes keys and element data.
+ * @param lpfnCompare Address of the routine that determines whether a key
+ * matches the data of an element.
+ * @param nExpectedCount Number of nodes the index is expected to hold; the
+ * table is sized so that it need not be grown until this number is exceeded.
+ */
+void CreateHashIndex(LPPHASH_INDEX lppIndex, LPHASH_ROUTINE lpfnHash,
+    LPCOMPARE_ROUTINE lpfnCompare, int nExpectedCount);
+
+/**
+ * @name DestroyHashIndex
+ * @brief Deallocates the index.  The nodes it refers to are not affected.
+ * @param lppIndex Address of a pointer to the index to be destroyed.  This
+ * pointer is reset to NULL.
+ */
+void DestroyHashIndex(LPPHASH_INDEX lppIndex);
+
+/**
+ * @name FindHashIndexEntry
+ * @brief Locates a node whose data matches the search key according to the
+ * index's comparison routine.
+ * @param lpIndex Address of the index.
+ * @param pvSearchKey Address of data to serve as a lookup key.
+ * @return Address of a matching node, or NULL if not found.  If several nodes
+ * match, which one of them is returned is unspecified.
+ * @remarks This operation takes expected constant time.
+ */
+LPPOSITION FindHashIndexEntry(LPHASH_INDEX lpIndex, void* pvSearchKey);
+
+/**
+ * @name RemoveHashIndexEntry
+ * @brief Removes a node from the index.
+ * @param lpIndex Address of the index.
+ * @param lpPosition Address of the node to be removed.  Its data must not have
+ * been deallocated or modified since the node was added to the index, since it
+ * is hashed in order to locate the node.
+ */
+void RemoveHashIndexEntry(LPHASH_INDEX lpIndex, LPPOSITION lpPosition);
+
+#endif //__HASH_INDEX_H__
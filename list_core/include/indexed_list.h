@@ -0,0 +1,211 @@
+// indexed_list.h - Defines the interface to the INDEXED_LIST data structure,
+// a list whose elements can be reached by their index in constant time.
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __INDEXED_LIST_H__
+#define __INDEXED_LIST_H__
+
+#include "list_core.h"
+
+/**
+ * @brief Number of data pointers for which room is made when the caller does
+ * not specify an initial capacity.
+ */
+#ifndef INDEXED_LIST_DEFAULT_CAPACITY
+#define INDEXED_LIST_DEFAULT_CAPACITY 16
+#endif //INDEXED_LIST_DEFAULT_CAPACITY
+
+/**
+ * @brief Structure that encapsulates a list whose elements are addressed by
+ * index.
+ *
+ * The data pointers are kept in a single array, known as a gap buffer: the
+ * unused slots of the array form one contiguous gap, which is moved to
+ * wherever an element is to be inserted or removed.  The element at any
+ * index is therefore found in constant time.  Inserting or removing an element
+ * takes time proportional to its distance from the previous insertion or
+ * removal, so a run of edits at or near one place, such as appending to the
+ * tail, takes constant amortized time per element.
+ */
+typedef struct _tagINDEXED_LIST {
+  void** ppvData;             // Slots, nCapacity in all
+  int nCapacity;
+  int nGapStart;              // Index of the first slot of the gap
+  int nGapEnd;                // Index of the first slot after the gap
+} INDEXED_LIST, *LPINDEXED_LIST, **LPPINDEXED_LIST;
+
+/**
+ * @name AddIndexedElement
+ * @brief Adds a new element to the tail of the list.
+ * @param lpList Address of the list.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @return TRUE if the element was added; FALSE otherwise.
+ */
+BOOL AddIndexedElement(LPINDEXED_LIST lpList, void* pvData);
+
+/**
+ * @name ClearIndexedList
+ * @brief Removes and deallocates all the elements from the list, leaving the
+ * list itself intact and empty.
+ * @param lpList Address of the list.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each element
+ * from the heap.  Supplied by the application.
+ * @remarks The list keeps its capacity.
+ */
+void ClearIndexedList(LPINDEXED_LIST lpList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name CreateIndexedList
+ * @brief Allocates a new, empty indexed list.
+ * @param lppList Address of a pointer that will receive the address of the
+ * new list.  The pointer is set to NULL if the allocation fails.
+ * @param nInitialCapacity Number of elements for which to make room up front.
+ * Specify zero to use INDEXED_LIST_DEFAULT_CAPACITY.
+ */
+void CreateIndexedList(LPPINDEXED_LIST lppList, int nInitialCapacity);
+
+/**
+ * @name CreateIndexedListFromPositions
+ * @brief Allocates a new indexed list that refers to the same data, in the
+ * same order, as an existing list of POSITION nodes.
+ * @param lppList Address of a pointer that will receive the address of the
+ * new list.  The pointer is set to NULL if the allocation fails.
+ * @param lpElement Address of any element of the existing list.  May be NULL,
+ * in which case the new list is empty.
+ * @remarks The existing list is not altered.  Both lists refer to the same
+ * data afterward, so only one of them should deallocate the data.
+ */
+void CreateIndexedListFromPositions(LPPINDEXED_LIST lppList,
+    LPPOSITION lpElement);
+
+/**
+ * @name CreateListFromIndexedList
+ * @brief Creates a new linked list of POSITION nodes that refers to the same
+ * data, in the same order, as an indexed list.
+ * @param lppNewHead Reference to a pointer that will receive the address of
+ * the head element of the new linked list.  The pointer is set to NULL if the
+ * indexed list is empty or if the new list could not be created.
+ * @param lpList Address of the indexed list.
+ * @return Number of elements in the new list; this is less than the number of
+ * elements of the indexed list only if memory could not be allocated for a
+ * new node.
+ * @remarks The elements of the indexed list are not altered.  Both lists refer
+ * to the same data afterward, so only one of them should deallocate the data.
+ */
+int CreateListFromIndexedList(LPPPOSITION lppNewHead, LPINDEXED_LIST lpList);
+
+/**
+ * @name DestroyIndexedList
+ * @brief Removes all the elements of the list and then deallocates the list.
+ * @param lppList Address of a pointer to the list to be destroyed.  This
+ * pointer is reset to NULL.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each element
+ * from the heap.  Supplied by the application.
+ */
+void DestroyIndexedList(LPPINDEXED_LIST lppList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name DoForEachIndexedElement
+ * @brief Executes an action for each of the elements of the list, in order.
+ * @param lpList Address of the list.
+ * @param lpfnAction Address of a function that specifies the code to run for
+ * each element of the list.
+ */
+void DoForEachIndexedElement(LPINDEXED_LIST lpList,
+    LPACTION_ROUTINE lpfnAction);
+
+/**
+ * @name GetIndexedElement
+ * @brief Gets the data of the element at the specified index.
+ * @param lpList Address of the list.
+ * @param nIndex Zero-based index of the element.
+ * @return Address of the element's data, or NULL if nIndex is out of range.
+ * @remarks This operation takes constant time.
+ */
+void* GetIndexedElement(LPINDEXED_LIST lpList, int nIndex);
+
+/**
+ * @name GetIndexedElementCount
+ * @brief Gets the count of the elements in the list.
+ * @param lpList Address of the list.
+ * @return Count of elements in the list, or zero if lpList is NULL.
+ * @remarks This operation takes constant time.
+ */
+int GetIndexedElementCount(LPINDEXED_LIST lpList);
+
+/**
+ * @name GetIndexedElements
+ * @brief Copies the data pointers of a run of consecutive elements, such as
+ * one page of results, into an array.
+ * @param lpList Address of the list.
+ * @param nStart Zero-based index of the first element to be copied.
+ * @param nCount Largest number of elements to be copied.
+ * @param ppvData Array of at least nCount items that receives the addresses
+ * of the elements' data.
+ * @return Number of items copied, which is less than nCount if the run
+ * reaches past the tail of the list; ERROR if a parameter is invalid.
+ * @remarks This operation takes time proportional to the number of items
+ * copied, regardless of nStart.
+ */
+int GetIndexedElements(LPINDEXED_LIST lpList, int nStart, int nCount,
+    void** ppvData);
+
+/**
+ * @name InsertIndexedElement
+ * @brief Inserts a new element at the specified index, so that the element
+ * that was there, and all those after it, move up by one.
+ * @param lpList Address of the list.
+ * @param nIndex Zero-based index at which to insert the element.  Passing
+ * the count of elements appends the new element to the tail.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @return TRUE if the element was inserted; FALSE if nIndex is out of range
+ * or memory could not be allocated.
+ */
+BOOL InsertIndexedElement(LPINDEXED_LIST lpList, int nIndex, void* pvData);
+
+/**
+ * @name RemoveIndexedElement
+ * @brief Removes the element at the specified index, so that all the elements
+ * after it move down by one.
+ * @param lpList Address of the list.
+ * @param nIndex Zero-based index of the element to be removed.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data the element
+ * refers to from the heap.
+ * @return TRUE if the element was removed; FALSE if nIndex is out of range.
+ */
+BOOL RemoveIndexedElement(LPINDEXED_LIST lpList, int nIndex,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name SetIndexedElement
+ * @brief Replaces the data of the element at the specified index.
+ * @param lpList Address of the list.
+ * @param nIndex Zero-based index of the element.
+ * @param pvData Address of the data to be pointed to by the element.
+ * @return Address of the data that the element pointed to before, or NULL if
+ * nIndex is out of range.  The old data are not deallocated.
+ * @remarks This operation takes constant time.
+ */
+void* SetIndexedElement(LPINDEXED_LIST lpList, int nIndex, void* pvData);
+
+#endif //__INDEXED_LIST_H__
@@ -0,0 +1,200 @@
+// intrusive_list.h - Defines the interface to the INTRUSIVE_LIST data
+// structure, a linked list whose links are embedded in the application's own
+// records.
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __INTRUSIVE_LIST_H__
+#define __INTRUSIVE_LIST_H__
+
+#include <stddef.h>
+
+#include "list_core.h"
+
+/**
+ * @brief Structure that links a record into an INTRUSIVE_LIST.  The
+ * application embeds one of these in each record that is to be placed in the
+ * list.
+ */
+typedef struct _tagINTRUSIVE_LINK {
+  struct _tagINTRUSIVE_LINK* pPrev;
+  struct _tagINTRUSIVE_LINK* pNext;
+} INTRUSIVE_LINK, *LPINTRUSIVE_LINK;
+
+/**
+ * @brief Structure that serves as the root of an intrusive list.
+ *
+ * Rather than allocating a POSITION node to point to each record, the list
+ * threads its links through an INTRUSIVE_LINK member of the records
+ * themselves, at the offset given when the list is initialized.  Adding and
+ * removing records therefore never allocates memory, and walking the list
+ * touches the records directly.  A record can be in one intrusive list per
+ * INTRUSIVE_LINK member that it has.
+ *
+ * The functions declared in this file take and return the addresses of the
+ * records, not of their links, and they pass the addresses of the records to
+ * the same callback types as the POSITION-based functions pass pvData.
+ * The list itself is not allocated by this library, so it may be embedded in
+ * another structure, or be declared on the stack or as a global.
+ */
+typedef struct _tagINTRUSIVE_LIST {
+  LPINTRUSIVE_LINK pHead;
+  LPINTRUSIVE_LINK pTail;
+  int nCount;
+  size_t nLinkOffset;         // Offset of the INTRUSIVE_LINK in each record
+} INTRUSIVE_LIST, *LPINTRUSIVE_LIST;
+
+/**
+ * @name AddIntrusiveElement
+ * @brief Adds a record to the tail of the list.
+ * @param lpList Address of the list.
+ * @param pvRecord Address of the record.  The record must not already be in
+ * the list.
+ * @remarks This operation takes constant time.
+ */
+void AddIntrusiveElement(LPINTRUSIVE_LIST lpList, void* pvRecord);
+
+/**
+ * @name AddIntrusiveElementAfter
+ * @brief Adds a record to the list after the specified record.
+ * @param lpList Address of the list.
+ * @param pvAfter Address of the record after which the new record is to be
+ * inserted.  If this value is NULL, the new record becomes the new head.
+ * @param pvRecord Address of the record to be added.  The record must not
+ * already be in the list.
+ * @remarks This operation takes constant time.
+ */
+void AddIntrusiveElementAfter(LPINTRUSIVE_LIST lpList, void* pvAfter,
+    void* pvRecord);
+
+/**
+ * @name ClearIntrusiveList
+ * @brief Removes all the records from the list, leaving it empty.
+ * @param lpList Address of the list.
+ * @param lpfnDeallocFunc Address of a function that is called for each record
+ * once it has been removed from the list, e.g., to free it.  Supplied by the
+ * application; pass DeallocateNothing if the records are managed elsewhere.
+ */
+void ClearIntrusiveList(LPINTRUSIVE_LIST lpList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name DoForEachIntrusiveElement
+ * @brief Executes an action for each of the records in the list, in order.
+ * @param lpList Address of the list.
+ * @param lpfnAction Address of a function that specifies the code to run for
+ * each record.  The action may remove the record it is given from the list,
+ * but no other.
+ */
+void DoForEachIntrusiveElement(LPINTRUSIVE_LIST lpList,
+    LPACTION_ROUTINE lpfnAction);
+
+/**
+ * @name FindIntrusiveElement
+ * @brief Locates the first record that matches the search key according to
+ * the specified comparison routine.
+ * @param lpList Address of the list.
+ * @param pvSearchKey Address of data to serve as a lookup key.
+ * @param lpfnCompare User-specified routine that determines whether a given
+ * record matches the key.
+ * @return Address of the matching record, or NULL if not found.
+ */
+void* FindIntrusiveElement(LPINTRUSIVE_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompare);
+
+/**
+ * @name FindIntrusiveElementWhere
+ * @brief Locates the first record for which the specified predicate function
+ * evaluates to TRUE.
+ * @param lpList Address of the list.
+ * @param lpfnPredicate Address of a user-specified predicate routine.
+ * @return Address of the matching record, or NULL if not found.
+ */
+void* FindIntrusiveElementWhere(LPINTRUSIVE_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate);
+
+/**
+ * @name GetIntrusiveElementCount
+ * @brief Gets the count of the records in the list.
+ * @param lpList Address of the list.
+ * @return Count of records in the list, or zero if lpList is NULL.
+ * @remarks This operation takes constant time.
+ */
+int GetIntrusiveElementCount(LPINTRUSIVE_LIST lpList);
+
+/**
+ * @name GetIntrusiveHead
+ * @brief Gets the address of the first record in the list.
+ * @param lpList Address of the list.
+ * @return Address of the head record, or NULL if the list is empty.
+ */
+void* GetIntrusiveHead(LPINTRUSIVE_LIST lpList);
+
+/**
+ * @name GetNextIntrusiveElement
+ * @brief Gets the address of the record that follows the specified record.
+ * @param lpList Address of the list.
+ * @param pvRecord Address of a record in the list.
+ * @return Address of the next record, or NULL if pvRecord is the tail.
+ */
+void* GetNextIntrusiveElement(LPINTRUSIVE_LIST lpList, void* pvRecord);
+
+/**
+ * @name InitializeIntrusiveList
+ * @brief Prepares an intrusive list for use, leaving it empty.
+ * @param lpList Address of the list.
+ * @param nLinkOffset Offset, in bytes, of the INTRUSIVE_LINK member within
+ * each record, as given by the offsetof macro, e.g.,
+ * offsetof(MESSAGE, link).
+ */
+void InitializeIntrusiveList(LPINTRUSIVE_LIST lpList, size_t nLinkOffset);
+
+/**
+ * @name RemoveIntrusiveElement
+ * @brief Removes the specified record from the list.
+ * @param lpList Address of the list.
+ * @param pvRecord Address of the record to be removed.  The record must be in
+ * the list.
+ * @param lpfnDeallocFunc Address of a function that is called for the record
+ * once it has been removed from the list, or NULL if the application will
+ * keep using the record.
+ * @return Address of the record that followed the removed record, or NULL if
+ * the removed record was the tail.
+ * @remarks This operation takes constant time.
+ */
+void* RemoveIntrusiveElement(LPINTRUSIVE_LIST lpList, void* pvRecord,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name RemoveIntrusiveElementWhere
+ * @brief Removes all the records from the list that match the search key
+ * according to the specified comparison routine.
+ * @param lpList Address of the list.
+ * @param pvSearchKey Address of data to be used as a key in the search for
+ * which records to remove.
+ * @param lpfnCompareFunc Address of a callback provided by the application
+ * that determines whether a record matches the key.
+ * @param lpfnDeallocFunc Address of a function that is called for each record
+ * once it has been removed from the list, or NULL if the application will
+ * keep using the records.
+ * @return Number of records that were removed from the list.
+ * @remarks The list is traversed only once.
+ */
+int RemoveIntrusiveElementWhere(LPINTRUSIVE_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareFunc, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+#endif //__INTRUSIVE_LIST_H__
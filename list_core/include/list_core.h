@@ -31,14 +31,39 @@
  */
 typedef void (*LPACTION_ROUTINE)(void* pvData);
 
+/**
+ * @brief Callback signature for an 'action' routine that also receives
+ * application-defined state.
+ * @param pvData Reference to the data that is tracked by the current node.
+ * @param pvContext Address of application-defined state, passed through
+ * unchanged from the caller of the function that runs the callback.
+ */
+typedef void (*LPACTION_ROUTINE_EX)(void* pvData, void* pvContext);
+
 /**
  * @brief Callback signature for a function that compares two objects.
  * @param pvData1 Instance of an object for the left side of the comparison.
  * @param pvData2 Instance of an object for the right side of the comparison.
  * @return TRUE if the objects match; FALSE otherwise.
+ * @remarks The routine must not remove elements from the list that is being
+ * walked, since the walk may already have read past the current element.
  */
 typedef BOOL (*LPCOMPARE_ROUTINE)(void* pvData1, void* pvData2);
 
+/**
+ * @brief Callback signature for a function that compares two objects, and
+ * that also receives application-defined state.
+ * @param pvData1 Instance of an object for the left side of the comparison.
+ * @param pvData2 Instance of an object for the right side of the comparison.
+ * @param pvContext Address of application-defined state, passed through
+ * unchanged from the caller of the function that runs the callback.
+ * @return TRUE if the objects match; FALSE otherwise.
+ * @remarks The routine must not remove elements from the list that is being
+ * walked, since the walk may already have read past the current element.
+ */
+typedef BOOL (*LPCOMPARE_ROUTINE_EX)(void* pvData1, void* pvData2,
+    void* pvContext);
+
 /**
  * @brief Callback that specifies deallocation logic for the data referenced.
  * @param pvData Address of the memory to be freed.
@@ -51,24 +76,88 @@ typedef BOOL (*LPCOMPARE_ROUTINE)(void* pvData1, void* pvData2);
  */
 typedef void (*LPDEALLOC_ROUTINE)(void* pvData);
 
+/**
+ * @brief Value returned by an iteration routine to have the iteration carry
+ * on to the next element.
+ */
+#define ITERATION_CONTINUE 0
+
+/**
+ * @brief Value returned by an iteration routine to have the iteration stop at
+ * the current element.
+ */
+#define ITERATION_STOP 1
+
+/**
+ * @brief Callback signature for an 'iteration' routine, i.e., a function that
+ * is run for each element of the list in turn, and that decides whether the
+ * iteration should go on.
+ * @param pvData Reference to the data that is tracked by the current node.
+ * @param pvContext Address of application-defined state, passed through
+ * unchanged from the caller of the iteration function.
+ * @return ITERATION_CONTINUE to go on to the next element, or ITERATION_STOP
+ * to end the iteration at this element.
+ */
+typedef int (*LPITERATION_ROUTINE)(void* pvData, void* pvContext);
+
 /**
  * @brief Callback that is a predicate; it simply gives the result of a
  * Boolean expression involving the specified data.
  * @param pvData Data to be used in the Boolean expression implemented by
  * this predicate.
  * @return Result of the predicate expression.
+ * @remarks The routine must not remove elements from the list that is being
+ * walked, since the walk may already have read past the current element.
  */
 typedef BOOL (*LPPREDICATE_ROUTINE)(void* pvData);
 
+/**
+ * @brief Callback that is a predicate, and that also receives application-
+ * defined state, e.g., the parameters of a query.
+ * @param pvData Data to be used in the Boolean expression implemented by
+ * this predicate.
+ * @param pvContext Address of application-defined state, passed through
+ * unchanged from the caller of the function that runs the callback.
+ * @return Result of the predicate expression.
+ * @remarks The routine must not remove elements from the list that is being
+ * walked, since the walk may already have read past the current element.
+ */
+typedef BOOL (*LPPREDICATE_ROUTINE_EX)(void* pvData, void* pvContext);
+
+/**
+ * @brief Callback signature for a function that determines the relative order
+ * of two objects.
+ * @param pvData1 Instance of an object for the left side of the comparison.
+ * @param pvData2 Instance of an object for the right side of the comparison.
+ * @return A negative value if pvData1 sorts before pvData2, zero if the two
+ * are equivalent, and a positive value if pvData1 sorts after pvData2, in the
+ * manner of the comparison routines used with qsort().
+ */
+typedef int (*LPSORT_COMPARE_ROUTINE)(void* pvData1, void* pvData2);
+
 /**
  * @brief Callback to implement the Sum function with.  This callback tells
  * us the quantity that should be the nth term of the sequence to be summed.
  * @param pvData Data referenced by the current linked-list item that should
  * be referenced in order to calculate the quantity returned by this function.
  * @return Quantity to be added to all the other terms in the summation.
+ * @remarks The routine must not remove elements from the list that is being
+ * walked, since the walk may already have read past the current element.
  */
 typedef int (*LPSUMMATION_ROUTINE)(void* pvData);
 
+/**
+ * @brief Callback to implement the SumElementsEx function with.
+ * @param pvData Data referenced by the current linked-list item that should
+ * be referenced in order to calculate the quantity returned by this function.
+ * @param pvContext Address of application-defined state, passed through
+ * unchanged from the caller of SumElementsEx or SumElementsWhereEx.
+ * @return Quantity to be added to all the other terms in the summation.
+ * @remarks The routine must not remove elements from the list that is being
+ * walked, since the walk may already have read past the current element.
+ */
+typedef int (*LPSUMMATION_ROUTINE_EX)(void* pvData, void* pvContext);
+
 /**
  * @name AddElement
  * @brief Adds a new element after the element currently being pointed at in
@@ -81,6 +170,41 @@ typedef int (*LPSUMMATION_ROUTINE)(void* pvData);
  */
 void AddElement(LPPPOSITION lppElement, void* pvData);
 
+/**
+ * @name AddElementsFromArray
+ * @brief Adds a new element to the tail of the linked list for each of the
+ * items of an array, in order; creates a new list if the current element
+ * pointer is NULL.
+ * @param lppElement Address of the current element pointer.  This value is
+ * reset to point to the tail of the list after a successful add operation.
+ * @param ppvData Array of addresses of data to be pointed to by the new
+ * elements.
+ * @param nCount Number of items in the ppvData array.
+ * @return Number of elements that were actually added; this is less than
+ * nCount only if memory could not be allocated for a new node.
+ * @remarks The tail of the list is located only once, and the new nodes are
+ * linked to each other in a single pass, rather than once per item as with
+ * repeated calls to AddElementToTail.
+ */
+int AddElementsFromArray(LPPPOSITION lppElement, void** ppvData, int nCount);
+
+/**
+ * @name AddElementSorted
+ * @brief Adds a new element to a linked list that is already in order,
+ * keeping it in order; creates a new list if the current element pointer is
+ * NULL.
+ * @param lppElement Address of the current element pointer.  This value is
+ * reset to point to the newly-added element after a successful add operation.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @param lpfnCompare Address of a callback that determines the relative order
+ * of the data of two elements.  The list must already be in the order that it
+ * defines, e.g., as a result of calling SortList with it.
+ * @remarks The new element is inserted after any elements that are equivalent
+ * to it, so that elements that compare equal stay in insertion order.
+ */
+void AddElementSorted(LPPPOSITION lppElement, void* pvData,
+    LPSORT_COMPARE_ROUTINE lpfnCompare);
+
 /**
  * @name AddElementToTail
  * @brief Adds a new element to the tail of the linked list; creates a new
@@ -105,10 +229,47 @@ void AddElementToTail(LPPPOSITION lppElement, void* pvData);
  * associated data as it goes. Since there is nothing in the list after this
  * function is complete, the current element pointer's value will be reset to
  * NULL after the operation. A NULL value for the current element pointer
- * signifies that there are zero elements in the list.
+ * signifies that there are zero elements in the list.  The whole list is
+ * detached first, and the elements are then deallocated in a single pass
+ * from the head, rather than being unlinked one at a time.
  */
 void ClearList(LPPPOSITION lppElement, LPDEALLOC_ROUTINE lpfnDeallocFunc);
 
+/**
+ * @name ClearListAsync
+ * @brief Detaches all the elements from the linked list, and has them
+ * deallocated on a background thread.
+ * @param lppElement Address of the current element pointer.  This value is
+ * reset to NULL before the function returns.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each node from
+ * the heap.  Supplied by the application.  It is called on the background
+ * thread, and so must be safe to call concurrently with whatever the
+ * application is doing in the meantime.
+ * @remarks Use this function to keep the teardown of a very large list from
+ * stalling the calling thread; the call only takes as long as it takes to
+ * find the head of the list.  If the background thread cannot be started,
+ * the list is cleared as by ClearList.  Call WaitForAsyncClears to wait for
+ * the deallocation to finish, e.g., before the program exits.
+ */
+void ClearListAsync(LPPPOSITION lppElement, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name ConcatenateLists
+ * @brief Moves all the elements of one linked list to the tail of another,
+ * by relinking the existing nodes.
+ * @param lppFirst Address of the current element pointer of the list to which
+ * the elements are added.  If this list is empty, the pointer is set to the
+ * head of the second list; otherwise, it is left as it is.
+ * @param lppSecond Address of the current element pointer of the list whose
+ * elements are moved.  This value is reset to NULL, since the list is left
+ * empty.  The two lists must be different lists.
+ * @remarks Nothing is allocated or freed.  The first list is walked to its
+ * tail and the second to its head, so the operation takes constant time if
+ * the current element pointers already point there.
+ */
+void ConcatenateLists(LPPPOSITION lppFirst, LPPPOSITION lppSecond);
+
 /**
  * @name CreateList
  * @param lppNewHead Reference to a pointer that will receive the address of
@@ -121,6 +282,20 @@ void ClearList(LPPPOSITION lppElement, LPDEALLOC_ROUTINE lpfnDeallocFunc);
  * function is done. */
 void CreateList(LPPPOSITION lppNewHead, void* pvData);
 
+/**
+ * @name CreateListFromArray
+ * @brief Creates a new linked list with one element for each of the items of
+ * an array, in order.
+ * @param lppNewHead Reference to a pointer that will receive the address of
+ * the head element of the new linked list.  The pointer is set to NULL if
+ * nCount is zero or if the list could not be created.
+ * @param ppvData Array of addresses of data to be pointed to by the elements.
+ * @param nCount Number of items in the ppvData array.
+ * @return Number of elements in the new list; this is less than nCount only
+ * if memory could not be allocated for a new node.
+ */
+int CreateListFromArray(LPPPOSITION lppNewHead, void** ppvData, int nCount);
+
 /**
  * @brief Deallocation routine to supply to ClearList that does a no-op.
  * @param pvData Address of the data to be deallocated.
@@ -156,6 +331,56 @@ void DefaultFree(void* pvData);
  */
 void DoForEach(LPPOSITION lpElement, LPACTION_ROUTINE lpfnAction);
 
+/**
+ * @name DoForEachEx
+ * @brief Executes an action for each of the elements of the linked list,
+ * passing the action application-defined state.
+ * @param lpElement Address of any element in the list.
+ * @param lpfnAction Address of a function that specifies the code to run for
+ * each element of the list.
+ * @param pvContext Address of application-defined state to be passed to each
+ * call of lpfnAction.  May be NULL.
+ * @remarks See DoForEach.
+ */
+void DoForEachEx(LPPOSITION lpElement, LPACTION_ROUTINE_EX lpfnAction,
+    void* pvContext);
+
+/**
+ * @name DoForEachInRange
+ * @brief Runs an iteration routine for each of the elements from one element
+ * of the linked list to another, inclusive, until the routine asks to stop.
+ * @param lpStart Address of the first element to visit.
+ * @param lpEnd Address of the last element to visit, which must be lpStart or
+ * come after it in the list; or NULL to carry on to the tail of the list.
+ * @param lpfnIteration Address of a function that specifies the code to run
+ * for each element, and whether to go on to the next one.
+ * @param pvContext Address of application-defined state to be passed to each
+ * call of lpfnIteration.  May be NULL.
+ * @return Address of the element at which lpfnIteration returned
+ * ITERATION_STOP, or NULL if every element in the range was visited.
+ * @remarks Unlike DoForEach, the iteration does not start from the head of the
+ * list, so no time is spent walking back to the head.
+ */
+LPPOSITION DoForEachInRange(LPPOSITION lpStart, LPPOSITION lpEnd,
+    LPITERATION_ROUTINE lpfnIteration, void* pvContext);
+
+/**
+ * @name DoForEachUntil
+ * @brief Runs an iteration routine for each of the elements of the linked
+ * list, starting from the head, until the routine asks to stop.
+ * @param lpElement Address of any element in the list.
+ * @param lpfnIteration Address of a function that specifies the code to run
+ * for each element, and whether to go on to the next one.
+ * @param pvContext Address of application-defined state to be passed to each
+ * call of lpfnIteration.  May be NULL.
+ * @return Address of the element at which lpfnIteration returned
+ * ITERATION_STOP, or NULL if every element of the list was visited.
+ * @remarks The current element pointer is not reset by this operation.  No
+ * element after the one at which the iteration stopped is visited.
+ */
+LPPOSITION DoForEachUntil(LPPOSITION lpElement,
+    LPITERATION_ROUTINE lpfnIteration, void* pvContext);
+
 /**
  * @name FindElement
  * @brief Locates the element that matches the criteria specified and
@@ -175,6 +400,23 @@ void DoForEach(LPPOSITION lpElement, LPACTION_ROUTINE lpfnAction);
 LPPOSITION FindElement(LPPOSITION lpElement, void* pvSearchKey,
 		LPCOMPARE_ROUTINE lpfnCompare);
 
+/**
+ * @name FindElementEx
+ * @brief Locates the first element from the head of the list whose data
+ * matches the search key according to a comparison routine that is passed
+ * application-defined state.
+ * @param lpElement Address of any element in the list.
+ * @param pvSearchKey Address of data to serve as a lookup key.
+ * @param lpfnCompare User-specified routine that determines whether a given
+ * element's data matches the key.
+ * @param pvContext Address of application-defined state to be passed to each
+ * call of lpfnCompare.  May be NULL.
+ * @return Address of the matching element, or NULL if not found.
+ * @remarks See FindElement.
+ */
+LPPOSITION FindElementEx(LPPOSITION lpElement, void* pvSearchKey,
+    LPCOMPARE_ROUTINE_EX lpfnCompare, void* pvContext);
+
 /**
  * @name FindElementWhere
  * @brief Locates the first element from the head of the list for which the
@@ -194,6 +436,20 @@ LPPOSITION FindElement(LPPOSITION lpElement, void* pvSearchKey,
 LPPOSITION FindElementWhere(LPPOSITION lpElement,
 		LPPREDICATE_ROUTINE lpfnPredicate);
 
+/**
+ * @name FindElementWhereEx
+ * @brief Locates the first element from the head of the list for which a
+ * predicate that is passed application-defined state evaluates to TRUE.
+ * @param lpElement Address of any element in the list.
+ * @param lpfnPredicate Address of a user-specified predicate routine.
+ * @param pvContext Address of application-defined state to be passed to each
+ * call of lpfnPredicate.  May be NULL.
+ * @return Address of the matching element, or NULL if not found.
+ * @remarks See FindElementWhere.
+ */
+LPPOSITION FindElementWhereEx(LPPOSITION lpElement,
+    LPPREDICATE_ROUTINE_EX lpfnPredicate, void* pvContext);
+
 /**
  * @name GetElementCount
  * @brief Gets the count of the elements in the list.
@@ -220,6 +476,21 @@ int GetElementCount(LPPOSITION lpElement);
 int GetElementCountWhere(LPPOSITION lpElement,
 		LPPREDICATE_ROUTINE lpfnPredicate);
 
+/**
+ * @name GetElementCountWhereEx
+ * @brief Gets the count of all elements in the list for which a predicate
+ * that is passed application-defined state returns TRUE.
+ * @param lpElement Address of any element from the list.
+ * @param lpfnPredicate Address of a user-specified predicate routine.
+ * @param pvContext Address of application-defined state to be passed to each
+ * call of lpfnPredicate.  May be NULL.
+ * @return Count of all the list's elements for which the predicate evaluates
+ * to TRUE.
+ * @remarks See GetElementCountWhere.
+ */
+int GetElementCountWhereEx(LPPOSITION lpElement,
+    LPPREDICATE_ROUTINE_EX lpfnPredicate, void* pvContext);
+
 /**
  * @name RemoveElement
  * @brief Removes an element from the list.
@@ -253,17 +524,134 @@ void RemoveElement(LPPPOSITION lppElement, LPDEALLOC_ROUTINE lpfnDeallocFunc);
  * @param lpfnDeallocFunc Address of a callback that implements application-
  * specific deallocation functionality to properly remove the data each node
  * refers to from the heap.
+ * @return Number of elements that were removed from the list.
  * @remarks Once the remove operation is complete, the current element pointer
  * is updated.  Applicatons should not make specific assumptions about the
  * final location of the current-element pointer, only that it still refers
  * to something in the list. If the pointer is set to NULL by this function,
  * then this means that all the elements in the entire list matched the search
- * and were thus removed.
+ * and were thus removed.  The list is traversed only once, from the head,
+ * no matter how many elements are removed.
  */
-void RemoveElementWhere(LPPPOSITION lppElement,
+int RemoveElementWhere(LPPPOSITION lppElement,
     void* pvSearchKey, LPCOMPARE_ROUTINE lpfnCompareFunc,
     LPDEALLOC_ROUTINE lpfnDeallocFunc);
 
+/**
+ * @name RemoveElementWhereEx
+ * @brief Removes all elements from the list that match the search key
+ * according to a comparison routine that is passed application-defined state.
+ * @param lppElement Address of the current element pointer maintained by the
+ * applications.
+ * @param pvSearchKey Address of data to be used as a key in the search for
+ * which elements to delete.
+ * @param lpfnCompareFunc Address of a callback provided by the application
+ * that determines whether an element's data matches the key.
+ * @param pvContext Address of application-defined state to be passed to each
+ * call of lpfnCompareFunc.  May be NULL.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data each node
+ * refers to from the heap.
+ * @return Number of elements that were removed from the list.
+ * @remarks See RemoveElementWhere.
+ */
+int RemoveElementWhereEx(LPPPOSITION lppElement, void* pvSearchKey,
+    LPCOMPARE_ROUTINE_EX lpfnCompareFunc, void* pvContext,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name RemoveElementWherePredicate
+ * @brief Removes all elements from the list for which the specified predicate
+ * function evaluates to TRUE.
+ * @param lppElement Address of the current element pointer maintained by the
+ * applications.  It does not matter where this pointer is actually pointing.
+ * The location of the pointer will be altered by this function to account
+ * for the removed elements.
+ * @param lpfnPredicate Address of a user-specified predicate routine that
+ * evaluates a Boolean expression for each element in the list.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data each node
+ * refers to from the heap.
+ * @return Number of elements that were removed from the list.
+ * @remarks The current element pointer is left where it was if that element
+ * was not removed; otherwise, it is reset to the head of the list, or to NULL
+ * if every element of the list was removed.  The list is traversed only once.
+ */
+int RemoveElementWherePredicate(LPPPOSITION lppElement,
+    LPPREDICATE_ROUTINE lpfnPredicate, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name RemoveElementWherePredicateEx
+ * @brief Removes all elements from the list for which a predicate that is
+ * passed application-defined state evaluates to TRUE.
+ * @param lppElement Address of the current element pointer maintained by the
+ * applications.
+ * @param lpfnPredicate Address of a user-specified predicate routine.
+ * @param pvContext Address of application-defined state to be passed to each
+ * call of lpfnPredicate.  May be NULL.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data each node
+ * refers to from the heap.
+ * @return Number of elements that were removed from the list.
+ * @remarks See RemoveElementWherePredicate.
+ */
+int RemoveElementWherePredicateEx(LPPPOSITION lppElement,
+    LPPREDICATE_ROUTINE_EX lpfnPredicate, void* pvContext,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name SortList
+ * @brief Sorts the elements of the linked list in place.
+ * @param lppElement Address of the current element pointer; it may point to
+ * any of the elements of the list.  This value is reset to point to the head
+ * of the sorted list.
+ * @param lpfnCompare Address of a callback that determines the relative order
+ * of the data of two elements.
+ * @remarks The sort is a bottom-up merge sort that relinks the existing nodes,
+ * so it takes O(N log N) time and allocates no memory.  It is stable, i.e.,
+ * elements that compare equal keep their relative order.
+ */
+void SortList(LPPPOSITION lppElement, LPSORT_COMPARE_ROUTINE lpfnCompare);
+
+/**
+ * @name SpliceElements
+ * @brief Moves a range of consecutive elements out of the list that contains
+ * them and into a list at the specified position, by relinking the existing
+ * nodes.
+ * @param lppDestination Address of the current element pointer of the list
+ * into which the elements are moved; it must not point to an element of the
+ * range.  If the list is empty, the range becomes the list, and this value is
+ * set to lpFirst.
+ * @param lpAfter Address of the element of the destination list after which
+ * the range is to be inserted.  If this value is NULL, the range becomes the
+ * new head of the destination list, and the current element pointer is reset
+ * to point to lpFirst.
+ * @param lpFirst Address of the first element of the range.
+ * @param lpLast Address of the last element of the range.  It must be
+ * lpFirst, or follow it in the same list.
+ * @remarks Nothing is allocated or freed.  The operation takes constant time,
+ * unless lpAfter is NULL, in which case the destination list is walked to its
+ * head.  The range may be moved within the list that contains it, as long as
+ * lpAfter is not part of it.  Any pointer the application holds to an element
+ * of the range as the current element of the source list must be updated by
+ * the application, since the element now belongs to the destination list.
+ */
+void SpliceElements(LPPPOSITION lppDestination, LPPOSITION lpAfter,
+    LPPOSITION lpFirst, LPPOSITION lpLast);
+
+/**
+ * @name SplitList
+ * @brief Splits a linked list in two, just before the specified element.
+ * @param lpElement Address of the element that is to become the head of the
+ * second list.
+ * @return Address of the tail of the first list, i.e., the element that used
+ * to precede lpElement, or NULL if lpElement was already the head, in which
+ * case the list is left as it is.
+ * @remarks Nothing is allocated or freed, and the operation takes constant
+ * time.
+ */
+LPPOSITION SplitList(LPPOSITION lpElement);
+
 /**
  * @name SumElements
  * @brief Calculates the sum of a sequence of quantities, which itself is
@@ -274,9 +662,26 @@ void RemoveElementWhere(LPPPOSITION lppElement,
  * of the summation, given the address of the data referenced by the current
  * node.
  * @return Result of the summation, or -1 if an error occurred.
+ * @remarks The sum is accumulated in an int, starting from zero.  To avoid
+ * overflow on long lists, use SumElementsInt64, declared in list_reduce.h.
  */
 int SumElements(LPPOSITION lpElement, LPSUMMATION_ROUTINE lpfnSumRoutine);
 
+/**
+ * @name SumElementsEx
+ * @brief Calculates the sum of a sequence of quantities computed from the data
+ * of the elements of the linked list by a callback that is passed
+ * application-defined state.
+ * @param lpElement Address of any of the nodes in the linked list.
+ * @param lpfnSumRoutine Address of a callback that calculates each term
+ * of the summation.
+ * @param pvContext Address of application-defined state to be passed to each
+ * call of lpfnSumRoutine.  May be NULL.
+ * @return Result of the summation, or -1 if an error occurred.
+ */
+int SumElementsEx(LPPOSITION lpElement, LPSUMMATION_ROUTINE_EX lpfnSumRoutine,
+    void* pvContext);
+
 /**
  * @name SumElementsWhere
  * @brief Calculates the sum of a sequence of quantities, which itself is
@@ -298,4 +703,33 @@ int SumElements(LPPOSITION lpElement, LPSUMMATION_ROUTINE lpfnSumRoutine);
 int SumElementsWhere(LPPOSITION lpElement, LPSUMMATION_ROUTINE lpfnSumRoutine,
     void* pvSearchKey, LPCOMPARE_ROUTINE lpfnCompareRoutine);
 
+/**
+ * @name SumElementsWhereEx
+ * @brief Calculates the sum of a sequence of quantities computed from the data
+ * of those elements of the linked list that match the search key, by means of
+ * callbacks that are passed application-defined state.
+ * @param lpElement Address of any of the nodes in the linked list.
+ * @param lpfnSumRoutine Address of a callback that calculates each term
+ * of the summation.
+ * @param pvSearchKey Address of user data that is to be utilized as a search
+ * key to check whether elements meet the criteria for being included in the
+ * summation.
+ * @param lpfnCompareRoutine Address of a callback that provides the criteria
+ * by which elements are to be included or excluded from the summation.
+ * @param pvContext Address of application-defined state to be passed to each
+ * call of lpfnSumRoutine and lpfnCompareRoutine.  May be NULL.
+ * @return Result of the summation, or -1 if an error occurred.  Returns zero
+ * if nothing is included in the sum.
+ */
+int SumElementsWhereEx(LPPOSITION lpElement,
+    LPSUMMATION_ROUTINE_EX lpfnSumRoutine, void* pvSearchKey,
+    LPCOMPARE_ROUTINE_EX lpfnCompareRoutine, void* pvContext);
+
+/**
+ * @name WaitForAsyncClears
+ * @brief Waits until every list that was handed to ClearListAsync or
+ * ClearListRootAsync has been deallocated.
+ */
+void WaitForAsyncClears(void);
+
 #endif //__LIST_CORE_H__
@@ -26,6 +26,15 @@
     "Must specify starting member.\n"
 #endif //ERROR_STARTING_MEMBER_NULL
 
+/**
+ * @brief Error message displayed when the allocation of a hash index, or of
+ * its table of slots, has failed.
+ */
+#ifndef FAILED_ALLOC_HASH_INDEX
+#define FAILED_ALLOC_HASH_INDEX \
+    "Failed to allocate memory for the hash index.\n"
+#endif //FAILED_ALLOC_HASH_INDEX
+
 /**
  * @brief Error message displayed when the allocation of the head of the linked
  * list has failed.
@@ -35,16 +44,62 @@
     "Failed to allocate memory for list head node.\n"
 #endif //FAILED_ALLOC_HEAD
 
+/**
+ * @brief Error message displayed when the allocation of the structure that
+ * describes a list of one of the specialized kinds (e.g., a skip list or an
+ * indexed list) has failed.
+ */
+#ifndef FAILED_ALLOC_LIST
+#define FAILED_ALLOC_LIST \
+    "Failed to allocate memory for the list structure.\n"
+#endif //FAILED_ALLOC_LIST
+
 #ifndef FAILED_ALLOC_LIST_ROOT
 #define FAILED_ALLOC_LIST_ROOT \
 	"Failed to allocate memory for the list root structure.\n"
 #endif //FAILED_ALLOC_LIST_ROOT
 
+/**
+ * @brief Error message displayed when the allocation of the storage in which
+ * a list keeps its elements, e.g., an array of data pointers, has failed.
+ */
+#ifndef FAILED_ALLOC_LIST_STORAGE
+#define FAILED_ALLOC_LIST_STORAGE \
+    "Failed to allocate memory for the storage of the list's elements.\n"
+#endif //FAILED_ALLOC_LIST_STORAGE
+
+/**
+ * @brief Error message displayed when the allocation of a view of a versioned
+ * list has failed.
+ */
+#ifndef FAILED_ALLOC_LIST_VIEW
+#define FAILED_ALLOC_LIST_VIEW \
+    "Failed to allocate memory for a view of the list.\n"
+#endif //FAILED_ALLOC_LIST_VIEW
+
 #ifndef FAILED_ALLOC_NEW_NODE
 #define FAILED_ALLOC_NEW_NODE \
     "Failed to allocate memory for a new linked list node.\n"
 #endif //FAILED_ALLOC_NEW_NODE
 
+/**
+ * @brief Error message displayed when the allocation of a pool of list nodes
+ * has failed.
+ */
+#ifndef FAILED_ALLOC_POSITION_POOL
+#define FAILED_ALLOC_POSITION_POOL \
+    "Failed to allocate memory for the pool of list nodes.\n"
+#endif //FAILED_ALLOC_POSITION_POOL
+
+/**
+ * @brief Error message displayed when the allocation of the structure that
+ * describes a queue has failed.
+ */
+#ifndef FAILED_ALLOC_QUEUE
+#define FAILED_ALLOC_QUEUE \
+    "Failed to allocate memory for the queue structure.\n"
+#endif //FAILED_ALLOC_QUEUE
+
 /**
  * @brief Error message displayed when the allocation of the root of the list
  * has failed.
@@ -54,6 +109,15 @@
     "Failed to allocate memory for list head node.\n"
 #endif //FAILED_ALLOC_ROOT
 
+/**
+ * @brief Error message displayed when the allocation of a list snapshot that
+ * is being mapped from a file has failed.
+ */
+#ifndef FAILED_ALLOC_SNAPSHOT
+#define FAILED_ALLOC_SNAPSHOT \
+    "Failed to allocate memory for the list snapshot.\n"
+#endif //FAILED_ALLOC_SNAPSHOT
+
 #ifndef FAILED_OPERATION_NULL_HEAD
 #define FAILED_OPERATION_NULL_HEAD \
     "Can't carry out the desired operation for each list element.\n" \
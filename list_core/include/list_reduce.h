@@ -0,0 +1,167 @@
+// list_reduce.h - Defines the interface to functions that reduce the elements
+// of a linked list to a single value, with wide and typed accumulators.
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __LIST_REDUCE_H__
+#define __LIST_REDUCE_H__
+
+#include <stdint.h>
+
+#include "list_core.h"
+
+/**
+ * @brief Callback that gives the 64-bit integer quantity that the data of an
+ * element contributes to a summation.
+ * @param pvData Data referenced by the current linked-list item.
+ * @return Quantity to be added to all the other terms in the summation.
+ * @remarks The routine must not remove elements from the list that is being
+ * walked, since the walk may already have read past the current element.
+ */
+typedef int64_t (*LPINT64_VALUE_ROUTINE)(void* pvData);
+
+/**
+ * @brief Callback that gives the floating-point quantity that the data of an
+ * element contributes to a summation.
+ * @param pvData Data referenced by the current linked-list item.
+ * @return Quantity to be added to all the other terms in the summation.
+ * @remarks The routine must not remove elements from the list that is being
+ * walked, since the walk may already have read past the current element.
+ */
+typedef double (*LPDOUBLE_VALUE_ROUTINE)(void* pvData);
+
+/**
+ * @brief Callback that folds the data of one element into an accumulator.
+ * @param pvAccumulator Address of the accumulator, which the callback updates
+ * in place.
+ * @param pvData Data referenced by the current linked-list item.
+ * @param pvContext Address of application-defined state, passed through
+ * unchanged from the caller of ReduceElements.
+ */
+typedef void (*LPREDUCE_ROUTINE)(void* pvAccumulator, void* pvData,
+    void* pvContext);
+
+/**
+ * @name ReduceElements
+ * @brief Folds the data of each of the elements of the linked list, starting
+ * from the head, into an accumulator of the application's choosing.
+ * @param lpElement Address of any of the nodes in the linked list.
+ * @param pvAccumulator Address of the accumulator.  The caller initializes it
+ * to the initial value of the reduction before the call, and it holds the
+ * result after the call.
+ * @param lpfnReduce Address of a callback that combines the data of each
+ * element with the accumulator.
+ * @param pvContext Address of application-defined state to be passed to each
+ * call of lpfnReduce.  May be NULL.
+ * @remarks The accumulator is left untouched if the list is empty.
+ */
+void ReduceElements(LPPOSITION lpElement, void* pvAccumulator,
+    LPREDUCE_ROUTINE lpfnReduce, void* pvContext);
+
+/**
+ * @name SumDoubleValues
+ * @brief Calculates the sum of an array of floating-point values.
+ * @param pdValues Address of the array.
+ * @param nCount Number of values in the array.
+ * @return The sum, or zero if the array is empty.
+ * @remarks This is the fast path for applications that have extracted the
+ * quantities to be summed from the list into an array.  The values are
+ * summed into several independent partial sums, which lets the compiler
+ * vectorize the loop and lets the processor overlap the additions, so the
+ * result may differ in the last bits from a strictly sequential sum.
+ */
+double SumDoubleValues(const double* pdValues, int nCount);
+
+/**
+ * @name SumElementsDouble
+ * @brief Calculates the sum of a sequence of floating-point quantities
+ * computed from the data of the elements of the linked list.
+ * @param lpElement Address of any of the nodes in the linked list.
+ * @param lpfnValue Address of a callback that calculates each term of the
+ * summation.
+ * @return The sum, or zero if the list is empty or lpfnValue is NULL.
+ */
+double SumElementsDouble(LPPOSITION lpElement,
+    LPDOUBLE_VALUE_ROUTINE lpfnValue);
+
+/**
+ * @name SumElementsInt64
+ * @brief Calculates the sum of a sequence of 64-bit integer quantities
+ * computed from the data of the elements of the linked list.
+ * @param lpElement Address of any of the nodes in the linked list.
+ * @param lpfnValue Address of a callback that calculates each term of the
+ * summation.
+ * @return The sum, or zero if the list is empty or lpfnValue is NULL.
+ * @remarks Unlike SumElements, the sum is accumulated in 64 bits, so it does
+ * not overflow on long lists of int-sized quantities.
+ */
+int64_t SumElementsInt64(LPPOSITION lpElement,
+    LPINT64_VALUE_ROUTINE lpfnValue);
+
+/**
+ * @name SumElementsWhereDouble
+ * @brief Calculates the sum of a sequence of floating-point quantities
+ * computed from the data of those elements of the linked list that match the
+ * search key.
+ * @param lpElement Address of any of the nodes in the linked list.
+ * @param lpfnValue Address of a callback that calculates each term of the
+ * summation.
+ * @param pvSearchKey Address of user data that is to be utilized as a search
+ * key to check whether elements meet the criteria for being included in the
+ * summation.
+ * @param lpfnCompareRoutine Address of a callback that provides the criteria
+ * by which elements are to be included or excluded from the summation.
+ * @return The sum, or zero if nothing is included in it or a required
+ * parameter is NULL.
+ */
+double SumElementsWhereDouble(LPPOSITION lpElement,
+    LPDOUBLE_VALUE_ROUTINE lpfnValue, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareRoutine);
+
+/**
+ * @name SumElementsWhereInt64
+ * @brief Calculates the sum of a sequence of 64-bit integer quantities
+ * computed from the data of those elements of the linked list that match the
+ * search key.
+ * @param lpElement Address of any of the nodes in the linked list.
+ * @param lpfnValue Address of a callback that calculates each term of the
+ * summation.
+ * @param pvSearchKey Address of user data that is to be utilized as a search
+ * key to check whether elements meet the criteria for being included in the
+ * summation.
+ * @param lpfnCompareRoutine Address of a callback that provides the criteria
+ * by which elements are to be included or excluded from the summation.
+ * @return The sum, or zero if nothing is included in it or a required
+ * parameter is NULL.
+ */
+int64_t SumElementsWhereInt64(LPPOSITION lpElement,
+    LPINT64_VALUE_ROUTINE lpfnValue, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareRoutine);
+
+/**
+ * @name SumInt64Values
+ * @brief Calculates the sum of an array of 64-bit integer values.
+ * @param pnValues Address of the array.
+ * @param nCount Number of values in the array.
+ * @return The sum, or zero if the array is empty.
+ * @remarks This is the fast path for applications that have extracted the
+ * quantities to be summed from the list into an array.  The loop is written
+ * so that the compiler can vectorize it.
+ */
+int64_t SumInt64Values(const int64_t* pnValues, int nCount);
+
+#endif //__LIST_REDUCE_H__
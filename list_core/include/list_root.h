@@ -0,0 +1,519 @@
+// list_root.h - Defines the interface to the LIST_ROOT data structure, which
+// tracks the head, tail and element count of a doubly-linked list.
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __LIST_ROOT_H__
+#define __LIST_ROOT_H__
+
+#include "list_core.h"
+#include "position_pool.h"
+#include "hash_index.h"
+#include "list_stats.h"
+
+/**
+ * @brief State of an incremental compaction of a list, as carried out by
+ * CompactListRootStep.
+ *
+ * The elements at the front of the list are moved, in order, into a block of
+ * contiguous nodes obtained from the root's pool.  pLastMoved marks how far
+ * the compaction has got; all of the elements up to and including it have
+ * already been moved.
+ */
+typedef struct _tagROOT_COMPACTION {
+  LPPOSITION pBlock;          // First node of the block; NULL when idle
+  int nCapacity;              // Number of nodes in the block
+  int nUsed;                  // Number of nodes of the block in use so far
+  LPPOSITION pLastMoved;      // Element most recently moved, if any
+} ROOT_COMPACTION, *LPROOT_COMPACTION;
+
+/**
+ * @brief Structure that serves as the root of a linked list.
+ *
+ * The root keeps track of the head and tail elements of the list, as well as
+ * the number of elements it contains, so that appending to the tail, looking
+ * up the head or tail, and counting the elements can be done in constant time.
+ * The elements themselves are ordinary POSITION nodes, so any of the functions
+ * declared in list_core.h that do not add or remove elements may be called on
+ * the head of the list.  Elements must only be added to, or removed from, a
+ * list that is managed by a root by means of the functions declared in this
+ * file; otherwise, the root's bookkeeping will become stale.
+ *
+ * Optionally, the root's nodes may be allocated from a POSITION_POOL, either
+ * one that is private to the list or one that is shared with other lists.
+ *
+ * Optionally, a HASH_INDEX may be attached to the root, in which case it is
+ * kept up to date as elements are added and removed, and keyed lookups and
+ * removals that use the index's comparison routine take expected constant
+ * time instead of walking the list.
+ *
+ * After a long period of churn, the nodes of a list end up scattered across
+ * memory, and walking it becomes slow.  CompactListRoot, or CompactListRootStep
+ * a few elements at a time, moves the nodes into a single contiguous block in
+ * list order.
+ *
+ * If the library is compiled with LIST_CORE_ENABLE_STATS defined, the root
+ * also keeps statistics of the work done on the list; see list_stats.h.
+ */
+typedef struct _tagLIST_ROOT {
+  LPPOSITION pHead;
+  LPPOSITION pTail;
+  int nCount;
+  LPPOSITION_POOL lpPool;
+  BOOL bOwnsPool;
+  LPHASH_INDEX lpIndex;
+  ROOT_COMPACTION compaction;
+  LIST_STATS stats;           // Maintained if LIST_CORE_ENABLE_STATS is set
+} LIST_ROOT, *LPLIST_ROOT, **LPPLIST_ROOT;
+
+/**
+ * @name AddRootElement
+ * @brief Adds a new element after the specified element of the list.
+ * @param lpRoot Address of the root of the list.
+ * @param lpAfter Address of the element after which the new element is to be
+ * inserted.  If this value is NULL, the new element becomes the new head.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @return Address of the newly-added element, or NULL if the element could
+ * not be added.
+ */
+LPPOSITION AddRootElement(LPLIST_ROOT lpRoot, LPPOSITION lpAfter,
+    void* pvData);
+
+/**
+ * @name AddRootElementsFromArray
+ * @brief Adds a new element to the tail of the list for each of the items of
+ * an array, in order.
+ * @param lpRoot Address of the root of the list.
+ * @param ppvData Array of addresses of data to be pointed to by the new
+ * elements.
+ * @param nCount Number of items in the ppvData array.
+ * @return Number of elements that were actually added; this is less than
+ * nCount only if memory could not be allocated.
+ * @remarks If the root allocates its nodes from a pool, all the new nodes are
+ * carved out of the pool as a single contiguous block; otherwise, they are
+ * allocated individually.  Either way, the nodes are linked in a single pass.
+ */
+int AddRootElementsFromArray(LPLIST_ROOT lpRoot, void** ppvData, int nCount);
+
+/**
+ * @name AddRootElementSorted
+ * @brief Adds a new element to a list that is already in order, keeping it in
+ * order.
+ * @param lpRoot Address of the root of the list.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @param lpfnCompare Address of a callback that determines the relative order
+ * of the data of two elements.  The list must already be in the order that it
+ * defines, e.g., as a result of calling SortListRoot with it.
+ * @return Address of the newly-added element, or NULL if the element could
+ * not be added.
+ * @remarks The new element is inserted after any elements that are equivalent
+ * to it.  If it does not sort before the tail, it is appended in constant
+ * time, so that adding elements in ascending order does not walk the list.
+ */
+LPPOSITION AddRootElementSorted(LPLIST_ROOT lpRoot, void* pvData,
+    LPSORT_COMPARE_ROUTINE lpfnCompare);
+
+/**
+ * @name AddRootElementToHead
+ * @brief Adds a new element to the head of the list.
+ * @param lpRoot Address of the root of the list.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @return Address of the newly-added element, or NULL if the element could
+ * not be added.
+ * @remarks This operation takes constant time.
+ */
+LPPOSITION AddRootElementToHead(LPLIST_ROOT lpRoot, void* pvData);
+
+/**
+ * @name AddRootElementToTail
+ * @brief Adds a new element to the tail of the list.
+ * @param lpRoot Address of the root of the list.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @return Address of the newly-added element, or NULL if the element could
+ * not be added.
+ * @remarks This operation takes constant time, unlike AddElementToTail, which
+ * must first walk to the tail of the list.
+ */
+LPPOSITION AddRootElementToTail(LPLIST_ROOT lpRoot, void* pvData);
+
+/**
+ * @name AttachRootHashIndex
+ * @brief Attaches a hash index to the list, so that FindRootElement and
+ * RemoveRootElementWhere no longer need to walk the list when they are called
+ * with the index's comparison routine.
+ * @param lpRoot Address of the root of the list.
+ * @param lpfnHash Address of a routine that hashes both search keys and the
+ * data of elements.  Whenever lpfnCompare deems a key to match an element's
+ * data, lpfnHash must return the same hash code for both.
+ * @param lpfnCompare Address of the comparison routine that keyed lookups
+ * will be made with.
+ * @return TRUE if the index was attached; FALSE if it could not be allocated.
+ * @remarks Any index already attached to the list is replaced.  The elements
+ * already in the list are indexed immediately.  The data of an indexed element
+ * must not be modified in a way that changes its hash code while the element
+ * is in the list.
+ */
+BOOL AttachRootHashIndex(LPLIST_ROOT lpRoot, LPHASH_ROUTINE lpfnHash,
+    LPCOMPARE_ROUTINE lpfnCompare);
+
+/**
+ * @name ClearListRoot
+ * @brief Removes and deallocates all the elements from the list, leaving the
+ * root itself intact and empty.
+ * @param lpRoot Address of the root of the list.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each node from
+ * the heap.  Supplied by the application.
+ * @remarks If the root owns a private pool, the nodes are released all at once
+ * by resetting the pool, after the data of each node has been deallocated.
+ */
+void ClearListRoot(LPLIST_ROOT lpRoot, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name ClearListRootAsync
+ * @brief Detaches all the elements from the list, leaving the root itself
+ * intact and empty, and has the elements deallocated on a background thread.
+ * @param lpRoot Address of the root of the list.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each node from
+ * the heap.  Supplied by the application.  It is called on the background
+ * thread, and so must be safe to call concurrently with whatever the
+ * application is doing in the meantime.
+ * @remarks The root is ready for use as soon as this function returns.  If
+ * the root owns a private pool, it is given a new, empty pool, and the old
+ * one is destroyed on the background thread once the data have been
+ * deallocated.  The nodes of a list whose pool is shared with other lists
+ * must go back to that pool, so such a list is cleared as by ClearListRoot.
+ * Call WaitForAsyncClears to wait for the deallocation to finish.
+ */
+void ClearListRootAsync(LPLIST_ROOT lpRoot, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name CompactListRoot
+ * @brief Moves all the elements of the list into a single block of contiguous
+ * nodes, laid out in list order, so that walking the list touches memory
+ * sequentially.
+ * @param lpRoot Address of the root of the list.
+ * @return TRUE if the list was compacted; FALSE if memory for the block could
+ * not be allocated, in which case the list is left as it was.
+ * @remarks A root that has no pool is given a private one to hold the block.
+ * If the root owns a private pool, the block is carved out of a new pool,
+ * and the old one, with all of its scattered slabs, is then destroyed; a
+ * shared pool simply receives the old nodes back.  Any incremental compaction
+ * that is under way is abandoned first.  Every element is moved, so the
+ * addresses of all the list's elements change, and any that the application
+ * holds become invalid.  The list's hash index, if any, is rebuilt.
+ */
+BOOL CompactListRoot(LPLIST_ROOT lpRoot);
+
+/**
+ * @name CompactListRootStep
+ * @brief Carries an incremental compaction of the list forward by a bounded
+ * number of elements.
+ * @param lpRoot Address of the root of the list.  The root must allocate its
+ * nodes from a pool; call CompactListRoot once to give it a private pool.
+ * @param nMaxCount Largest number of elements to be moved by this call.
+ * @return Upper bound on the number of elements that are still to be moved,
+ * or zero once the compaction is complete; ERROR if the root has no pool or
+ * the block could not be allocated.
+ * @remarks The first call obtains a block large enough for all the elements
+ * the list contains at that time, and every call moves the next elements in
+ * list order into it.  Between calls, the list may be used, and modified,
+ * as usual; elements that are added ahead of the point the compaction has
+ * reached are not moved.  Each element that is moved gets a new address, so
+ * the application must not hold on to the addresses of elements across a
+ * call.  Once the end of the list is reached or the block is full, unused
+ * nodes of the block are given back to the pool, and the next call starts
+ * a fresh compaction.
+ */
+int CompactListRootStep(LPLIST_ROOT lpRoot, int nMaxCount);
+
+/**
+ * @name ConcatenateListRoots
+ * @brief Moves all the elements of one list to the tail of another, by
+ * relinking the existing nodes.
+ * @param lpFirst Address of the root of the list to which the elements are
+ * added.
+ * @param lpSecond Address of the root of the list whose elements are moved.
+ * The root itself is left intact and empty.
+ * @return TRUE if the elements were moved, or there were none to move; FALSE
+ * if the two roots are the same, the two lists do not allocate their nodes
+ * compatibly (see SpliceRootElements), or memory could not be allocated to
+ * index the elements.
+ * @remarks Takes constant time, unless either list has a hash index.
+ */
+BOOL ConcatenateListRoots(LPLIST_ROOT lpFirst, LPLIST_ROOT lpSecond);
+
+/**
+ * @name CreateListRoot
+ * @brief Allocates a new, empty list root.
+ * @param lppRoot Address of a pointer that will receive the address of the
+ * newly-allocated root.  The pointer is set to NULL if the allocation fails.
+ */
+void CreateListRoot(LPPLIST_ROOT lppRoot);
+
+/**
+ * @name CreateListRootFromArray
+ * @brief Allocates a new list root with one element for each of the items of
+ * an array, in order.
+ * @param lppRoot Address of a pointer that will receive the address of the
+ * newly-allocated root.  The pointer is set to NULL if the allocation fails.
+ * @param ppvData Array of addresses of data to be pointed to by the elements.
+ * @param nCount Number of items in the ppvData array.
+ * @return Number of elements in the new list.
+ * @remarks The root is given a private pool, and all of the list's nodes are
+ * allocated from it as one contiguous block.
+ */
+int CreateListRootFromArray(LPPLIST_ROOT lppRoot, void** ppvData, int nCount);
+
+/**
+ * @name CreateListRootWithPool
+ * @brief Allocates a new, empty list root whose nodes are allocated from an
+ * existing pool, which may be shared with other lists.
+ * @param lppRoot Address of a pointer that will receive the address of the
+ * newly-allocated root.  The pointer is set to NULL if the allocation fails.
+ * @param lpPool Address of the pool from which to allocate the list's nodes.
+ * The pool must outlive the root, and must be thread-safe if it is shared by
+ * lists that are used from different threads.
+ */
+void CreateListRootWithPool(LPPLIST_ROOT lppRoot, LPPOSITION_POOL lpPool);
+
+/**
+ * @name CreatePooledListRoot
+ * @brief Allocates a new, empty list root that allocates its nodes from a
+ * private pool of its own.
+ * @param lppRoot Address of a pointer that will receive the address of the
+ * newly-allocated root.  The pointer is set to NULL if the allocation fails.
+ * @param nSlabSize Number of nodes to carve out of each of the pool's slabs.
+ * Specify zero to use POSITION_POOL_DEFAULT_SLAB_SIZE.
+ * @remarks The private pool is destroyed along with the root.
+ */
+void CreatePooledListRoot(LPPLIST_ROOT lppRoot, int nSlabSize);
+
+/**
+ * @name DestroyListRoot
+ * @brief Removes all the elements of the list and then deallocates the root.
+ * @param lppRoot Address of a pointer to the root to be destroyed.  This
+ * pointer is reset to NULL.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each node from
+ * the heap.  Supplied by the application.
+ * @remarks If the root owns a private pool, the pool is destroyed as well.
+ */
+void DestroyListRoot(LPPLIST_ROOT lppRoot, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name DetachRootHashIndex
+ * @brief Detaches and deallocates the list's hash index, if it has one.
+ * @param lpRoot Address of the root of the list.
+ */
+void DetachRootHashIndex(LPLIST_ROOT lpRoot);
+
+/**
+ * @name DoForEachRootElement
+ * @brief Executes an action for each of the elements of the list, starting
+ * from the head.
+ * @param lpRoot Address of the root of the list.
+ * @param lpfnAction Address of a function that specifies the code to run for
+ * each element of the list.
+ */
+void DoForEachRootElement(LPLIST_ROOT lpRoot, LPACTION_ROUTINE lpfnAction);
+
+/**
+ * @name FindRootElement
+ * @brief Locates the first element, starting from the head, whose data
+ * matches the search key according to the specified comparison routine.
+ * @param lpRoot Address of the root of the list.
+ * @param pvSearchKey Address of data to serve as a lookup key.
+ * @param lpfnCompare User-specified routine that determines whether a given
+ * element's data matches the key.
+ * @return Address of the matching element, or NULL if not found.
+ * @remarks If a hash index is attached to the list and lpfnCompare is the
+ * index's comparison routine, the index is used instead of walking the list;
+ * if several elements then match, which one of them is returned is
+ * unspecified.
+ */
+LPPOSITION FindRootElement(LPLIST_ROOT lpRoot, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompare);
+
+/**
+ * @name FindRootElementWhere
+ * @brief Locates the first element, starting from the head, for which the
+ * specified predicate function evaluates to TRUE.
+ * @param lpRoot Address of the root of the list.
+ * @param lpfnPredicate Address of a user-specified predicate routine.
+ * @return Address of the matching element, or NULL if not found.
+ */
+LPPOSITION FindRootElementWhere(LPLIST_ROOT lpRoot,
+    LPPREDICATE_ROUTINE lpfnPredicate);
+
+/**
+ * @name GetListRootStats
+ * @brief Retrieves a copy of the statistics of the list.
+ * @param lpRoot Address of the root of the list.
+ * @param lpStats Address of a structure that receives the statistics.  It is
+ * filled with zeroes unless the library was compiled with
+ * LIST_CORE_ENABLE_STATS defined.
+ */
+void GetListRootStats(LPLIST_ROOT lpRoot, LPLIST_STATS lpStats);
+
+/**
+ * @name GetRootElementCount
+ * @brief Gets the count of the elements in the list.
+ * @param lpRoot Address of the root of the list.
+ * @return Count of elements in the list, or zero if lpRoot is NULL.
+ * @remarks This operation takes constant time.
+ */
+int GetRootElementCount(LPLIST_ROOT lpRoot);
+
+/**
+ * @name GetRootHead
+ * @brief Gets the address of the head element of the list.
+ * @param lpRoot Address of the root of the list.
+ * @return Address of the head element, or NULL if the list is empty.
+ * @remarks This operation takes constant time.
+ */
+LPPOSITION GetRootHead(LPLIST_ROOT lpRoot);
+
+/**
+ * @name GetRootTail
+ * @brief Gets the address of the tail element of the list.
+ * @param lpRoot Address of the root of the list.
+ * @return Address of the tail element, or NULL if the list is empty.
+ * @remarks This operation takes constant time.
+ */
+LPPOSITION GetRootTail(LPLIST_ROOT lpRoot);
+
+/**
+ * @name RemoveRootElement
+ * @brief Removes the specified element from the list.
+ * @param lpRoot Address of the root of the list.
+ * @param lpElement Address of the element to be removed.  The element must
+ * belong to the list managed by lpRoot.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data the node
+ * refers to from the heap.
+ * @return Address of the element that followed the removed element, or NULL
+ * if the removed element was the tail.
+ */
+LPPOSITION RemoveRootElement(LPLIST_ROOT lpRoot, LPPOSITION lpElement,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name RemoveRootElementWhere
+ * @brief Removes all elements from the list whose data match the search key
+ * according to the specified comparison routine.
+ * @param lpRoot Address of the root of the list.
+ * @param pvSearchKey Address of data to be used as a key in the search for
+ * which elements to delete.
+ * @param lpfnCompareFunc Address of a callback provided by the application
+ * that determines whether an element's data matches the key.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data each node
+ * refers to from the heap.
+ * @return Number of elements that were removed from the list.
+ * @remarks The list is traversed only once.  If a hash index is attached to
+ * the list and lpfnCompareFunc is the index's comparison routine, only the
+ * matching elements are visited.
+ */
+int RemoveRootElementWhere(LPLIST_ROOT lpRoot, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareFunc, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name RemoveRootElementWherePredicate
+ * @brief Removes all elements from the list for which the specified predicate
+ * function evaluates to TRUE.
+ * @param lpRoot Address of the root of the list.
+ * @param lpfnPredicate Address of a user-specified predicate routine.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data each node
+ * refers to from the heap.
+ * @return Number of elements that were removed from the list.
+ * @remarks The list is traversed only once.
+ */
+int RemoveRootElementWherePredicate(LPLIST_ROOT lpRoot,
+    LPPREDICATE_ROUTINE lpfnPredicate, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name ResetListRootStats
+ * @brief Resets all of the statistics of the list to zero.
+ * @param lpRoot Address of the root of the list.
+ */
+void ResetListRootStats(LPLIST_ROOT lpRoot);
+
+/**
+ * @name SortListRoot
+ * @brief Sorts the elements of the list in place.
+ * @param lpRoot Address of the root of the list.
+ * @param lpfnCompare Address of a callback that determines the relative order
+ * of the data of two elements.
+ * @remarks See SortList.  The nodes are relinked rather than reallocated, so
+ * the addresses of the elements remain valid.
+ */
+void SortListRoot(LPLIST_ROOT lpRoot, LPSORT_COMPARE_ROUTINE lpfnCompare);
+
+/**
+ * @name SpliceRootElements
+ * @brief Moves a range of consecutive elements from one list into another at
+ * the specified position, by relinking the existing nodes.
+ * @param lpDestination Address of the root of the list into which the
+ * elements are moved.
+ * @param lpAfter Address of the element of the destination list after which
+ * the range is to be inserted.  If this value is NULL, the range becomes the
+ * new head of the destination list.
+ * @param lpSource Address of the root of the list that contains the range.
+ * It may be the same as lpDestination, provided that lpAfter is not part of
+ * the range.
+ * @param lpFirst Address of the first element of the range.
+ * @param lpLast Address of the last element of the range.  It must be
+ * lpFirst, or follow it in the same list.
+ * @param nCount Number of elements in the range, if the application knows it;
+ * otherwise, ERROR, in which case the range is walked in order to count them.
+ * A wrong count corrupts the bookkeeping of both roots.
+ * @return TRUE if the elements were moved; FALSE if a required parameter is
+ * NULL, the two lists do not allocate their nodes compatibly, or memory could
+ * not be allocated to index the elements, in which case neither list is
+ * changed.
+ * @remarks Since the nodes themselves change lists, the lists must allocate
+ * them compatibly: either both from the heap, or both from the same shared
+ * pool.  A list that owns a private pool can only splice within itself.
+ * Given the count, the operation takes constant time, unless either list has
+ * a hash index, in which case the range is walked in order to move the
+ * elements from the one index to the other.  Any incremental compaction of
+ * the source list that is under way is abandoned.
+ */
+BOOL SpliceRootElements(LPLIST_ROOT lpDestination, LPPOSITION lpAfter,
+    LPLIST_ROOT lpSource, LPPOSITION lpFirst, LPPOSITION lpLast, int nCount);
+
+/**
+ * @name SplitListRoot
+ * @brief Moves the specified element, and all the elements after it, to the
+ * tail of another list.
+ * @param lpRoot Address of the root of the list to be split.
+ * @param lpElement Address of the element at which the list is to be split.
+ * @param lpNewRoot Address of the root of the list that receives the
+ * elements; typically a new, empty one.
+ * @return TRUE if the elements were moved; FALSE otherwise.  See
+ * SpliceRootElements.
+ * @remarks The elements that are moved are counted by walking outwards from
+ * lpElement in both directions at once, so the cost is proportional to the
+ * shorter of the two parts, not to the length of the list.
+ */
+BOOL SplitListRoot(LPLIST_ROOT lpRoot, LPPOSITION lpElement,
+    LPLIST_ROOT lpNewRoot);
+
+#endif //__LIST_ROOT_H__
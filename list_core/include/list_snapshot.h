@@ -0,0 +1,212 @@
+// list_snapshot.h - Defines the interface to list snapshots, which save a
+// linked list to a file in a single pass, and either load it back or map it
+// into memory as a read-only list
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __LIST_SNAPSHOT_H__
+#define __LIST_SNAPSHOT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "list_core.h"
+
+/**
+ * @brief Value that identifies a snapshot file; the characters "LCSN" when
+ * written in little-endian byte order.
+ */
+#define LIST_SNAPSHOT_MAGIC   0x4E53434CU
+
+/**
+ * @brief Version of the snapshot file format that this library writes.
+ */
+#define LIST_SNAPSHOT_VERSION 1
+
+/**
+ * @brief Boundary to which the start of each record in a snapshot file is
+ * aligned, so that mapped records may be accessed in place as structures.
+ */
+#define LIST_SNAPSHOT_ALIGNMENT 8
+
+/**
+ * @brief Size of the buffer through which a snapshot is written.  A record
+ * that does not fit is given a buffer of its own.
+ */
+#ifndef LIST_SNAPSHOT_BUFFER_SIZE
+#define LIST_SNAPSHOT_BUFFER_SIZE 65536
+#endif //LIST_SNAPSHOT_BUFFER_SIZE
+
+/**
+ * @brief Defines the format of a routine that serializes the data of a list
+ * element into a buffer.
+ * @param pvData Address of the data to be serialized.
+ * @param pvBuffer Address of the buffer that receives the serialized record.
+ * @param nBufferSize Size, in bytes, of the buffer.
+ * @return Size, in bytes, of the serialized record, or a negative value if
+ * the data cannot be serialized.  If the record needs more than nBufferSize
+ * bytes, the routine returns the size that it needs, and it is called again
+ * with a buffer that is at least that large.
+ */
+typedef int (*LPSERIALIZE_ROUTINE)(void* pvData, void* pvBuffer,
+    int nBufferSize);
+
+/**
+ * @brief Defines the format of a routine that rebuilds the data of a list
+ * element from a serialized record.
+ * @param pvRecord Address of the record, as written by the matching
+ * LPSERIALIZE_ROUTINE.  The address is aligned to LIST_SNAPSHOT_ALIGNMENT
+ * bytes.  The record must not be modified, and it is not valid once the
+ * routine returns.
+ * @param nSize Size, in bytes, of the record.
+ * @return Address of the data to be pointed to by the new element, or NULL
+ * if the data cannot be rebuilt.
+ */
+typedef void* (*LPDESERIALIZE_ROUTINE)(const void* pvRecord, int nSize);
+
+/**
+ * @brief Header with which every snapshot file begins.
+ *
+ * The header is followed by nCount records, each of which consists of a
+ * SNAPSHOT_RECORD_HEADER and the serialized data, padded to a multiple of
+ * LIST_SNAPSHOT_ALIGNMENT bytes.  All of the fields are in the byte order of
+ * the machine that wrote the snapshot; a snapshot written on a machine of the
+ * other byte order is rejected, since its magic number does not match.
+ */
+typedef struct _tagSNAPSHOT_HEADER {
+  uint32_t nMagic;            // LIST_SNAPSHOT_MAGIC
+  uint32_t nVersion;          // LIST_SNAPSHOT_VERSION
+  uint32_t nCount;            // Number of records that follow
+  uint32_t nReserved;         // Zero
+} SNAPSHOT_HEADER, *LPSNAPSHOT_HEADER;
+
+/**
+ * @brief Header that precedes each record in a snapshot file.
+ */
+typedef struct _tagSNAPSHOT_RECORD_HEADER {
+  uint32_t nSize;             // Size of the record, excluding padding
+  uint32_t nReserved;         // Zero
+} SNAPSHOT_RECORD_HEADER, *LPSNAPSHOT_RECORD_HEADER;
+
+/**
+ * @brief Structure that presents a mapped snapshot file as a linked list.
+ *
+ * The file is mapped into memory read-only, and the list is made up of a
+ * single block of POSITION nodes, allocated along with this structure, whose
+ * pvData members point straight at the records in the mapping.  Mapping a
+ * snapshot therefore takes a single allocation, regardless of the number of
+ * elements, and no record is copied or rebuilt.
+ *
+ * The list may be passed to any of the functions declared in list_core.h
+ * that neither add nor remove elements, e.g., DoForEach, FindElement or
+ * GetElementCount.  The data must be treated as read-only; an attempt to
+ * write to it faults.  The list remains valid until the snapshot is unmapped.
+ */
+typedef struct _tagLIST_SNAPSHOT {
+  void* pvMapping;            // Address at which the file is mapped
+  size_t nMappingSize;        // Size of the mapping, in bytes
+  int nCount;                 // Number of elements
+  POSITION aPositions[];      // One node per element, linked in order
+} LIST_SNAPSHOT, *LPLIST_SNAPSHOT, **LPPLIST_SNAPSHOT;
+
+/**
+ * @name GetListSnapshotCount
+ * @brief Gets the count of the elements in a mapped snapshot.
+ * @param lpSnapshot Address of the snapshot.
+ * @return Count of the elements, or zero if lpSnapshot is NULL.
+ */
+int GetListSnapshotCount(LPLIST_SNAPSHOT lpSnapshot);
+
+/**
+ * @name GetListSnapshotHead
+ * @brief Gets the head element of the list that presents a mapped snapshot.
+ * @param lpSnapshot Address of the snapshot.
+ * @return Address of the head element, or NULL if the snapshot is empty.
+ */
+LPPOSITION GetListSnapshotHead(LPLIST_SNAPSHOT lpSnapshot);
+
+/**
+ * @name LoadListSnapshot
+ * @brief Creates a new linked list from the records of a snapshot file.
+ * @param lppNewHead Reference to a pointer that will receive the address of
+ * the head element of the new linked list.  The pointer is set to NULL if the
+ * snapshot is empty.
+ * @param pszPath Path to the snapshot file.
+ * @param lpfnDeserialize Address of a routine that rebuilds the data of each
+ * element from its record.
+ * @param lpfnDeallocFunc Address of a routine that deallocates the data that
+ * were rebuilt from a record, but could not be added to the list because no
+ * node could be allocated for them, or NULL if such data need no
+ * deallocation.
+ * @return Number of elements in the new list, or ERROR if the file cannot be
+ * read, is not a valid snapshot, or a record cannot be rebuilt.
+ * @remarks The file is mapped, rather than read, and the new nodes are linked
+ * in batches, so the cost of loading is dominated by the deserialize routine.
+ * If an error occurs part way through, the elements that were loaded so far
+ * are left in the list, so that the application can deallocate them; the data
+ * rebuilt for any others have already been passed to lpfnDeallocFunc.
+ */
+int LoadListSnapshot(LPPPOSITION lppNewHead, const char* pszPath,
+    LPDESERIALIZE_ROUTINE lpfnDeserialize, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name MapListSnapshot
+ * @brief Maps a snapshot file into memory and presents it as a read-only
+ * linked list.
+ * @param lppSnapshot Address of a pointer that will receive the address of
+ * the snapshot.  The pointer is set to NULL if the file cannot be mapped or
+ * is not a valid snapshot.
+ * @param pszPath Path to the snapshot file.
+ * @remarks Use this function, rather than LoadListSnapshot, when the records
+ * can be used in place, e.g., because they are structures without pointers.
+ * Mapping walks the record headers once, in order to link the nodes, but no
+ * record is copied or rebuilt.  The file must not be modified while it is
+ * mapped.
+ */
+void MapListSnapshot(LPPLIST_SNAPSHOT lppSnapshot, const char* pszPath);
+
+/**
+ * @name SaveListSnapshot
+ * @brief Writes a linked list to a snapshot file.
+ * @param lpElement Address of any element of the list, or NULL to write an
+ * empty snapshot.
+ * @param pszPath Path to the snapshot file.  If the file already exists, it
+ * is replaced.
+ * @param lpfnSerialize Address of a routine that serializes the data of each
+ * element.
+ * @return Number of elements written, or ERROR if the file cannot be written
+ * or an element cannot be serialized.
+ * @remarks The list is walked once, and the records are written through a
+ * buffer of LIST_SNAPSHOT_BUFFER_SIZE bytes into which they are serialized
+ * directly.  The snapshot is written to a temporary file alongside pszPath,
+ * which is then renamed, so that an existing snapshot is not lost if the
+ * save fails.
+ */
+int SaveListSnapshot(LPPOSITION lpElement, const char* pszPath,
+    LPSERIALIZE_ROUTINE lpfnSerialize);
+
+/**
+ * @name UnmapListSnapshot
+ * @brief Releases a mapped snapshot, along with the list that presents it.
+ * @param lppSnapshot Address of a pointer to the snapshot.  This pointer is
+ * reset to NULL.
+ * @remarks Every element of the list, and every address of a record that
+ * was obtained from it, becomes invalid.
+ */
+void UnmapListSnapshot(LPPLIST_SNAPSHOT lppSnapshot);
+
+#endif //__LIST_SNAPSHOT_H__
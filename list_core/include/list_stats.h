@@ -0,0 +1,83 @@
+// list_stats.h - Defines the interface to the optional statistics that
+// list_core keeps about its own behavior
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __LIST_STATS_H__
+#define __LIST_STATS_H__
+
+#include <stdio.h>
+
+/**
+ * @brief Counters that describe the work done by the library.
+ *
+ * The counters are only maintained if the library is compiled with
+ * LIST_CORE_ENABLE_STATS defined; otherwise, the code that would update them
+ * is compiled out altogether, and they remain zero.  The structure, and the
+ * functions that read it, exist either way, so that the layout of LIST_ROOT
+ * and the library's exports do not depend on the setting.
+ *
+ * One set of counters covers the whole process.  Each LIST_ROOT also has its
+ * own set, which counts the work done by the functions that are called on
+ * that root, including the list_core.h functions they call in turn.
+ */
+typedef struct _tagLIST_STATS {
+  long nNodesTraversed;       // Elements visited while walking lists
+  long nHeadSeeks;            // Calls to MoveToHeadPosition
+  long nAllocations;          // Nodes allocated, from the heap or a pool
+  long nFrees;                // Nodes deallocated, to the heap or a pool
+  long nComparisons;          // Calls to compare and predicate routines
+  long nMaxLength;            // Longest list seen
+} LIST_STATS, *LPLIST_STATS;
+
+/**
+ * @name AreListStatsEnabled
+ * @brief Determines whether the library was compiled to maintain statistics.
+ * @return TRUE if LIST_CORE_ENABLE_STATS was defined when the library was
+ * compiled; FALSE otherwise.
+ */
+BOOL AreListStatsEnabled(void);
+
+/**
+ * @name DumpListStats
+ * @brief Writes a set of statistics as human-readable text, one counter per
+ * line.
+ * @param fp Stream to which the text is to be written, e.g., stderr.
+ * @param lpStats Address of the statistics to be written, as obtained from
+ * GetListStats or GetListRootStats.  Specify NULL to write the process-wide
+ * statistics.
+ */
+void DumpListStats(FILE* fp, LPLIST_STATS lpStats);
+
+/**
+ * @name GetListStats
+ * @brief Retrieves a copy of the process-wide statistics.
+ * @param lpStats Address of a structure that receives the statistics.
+ * @remarks The counters are updated independently of each other, so a copy
+ * taken while other threads are using the library may be slightly
+ * inconsistent.  The work that a function does on a LIST_ROOT is counted as
+ * the function returns.
+ */
+void GetListStats(LPLIST_STATS lpStats);
+
+/**
+ * @name ResetListStats
+ * @brief Resets all of the process-wide statistics to zero.
+ */
+void ResetListStats(void);
+
+#endif //__LIST_STATS_H__
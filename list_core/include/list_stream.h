@@ -0,0 +1,137 @@
+// list_stream.h - Defines the interface to the functions that build linked
+// lists from records read from a file descriptor, such as a pipe or socket
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __LIST_STREAM_H__
+#define __LIST_STREAM_H__
+
+#include "list_core.h"
+#include "list_root.h"
+
+/**
+ * @brief Size of the buffer into which a stream is read when the caller does
+ * not specify one.
+ */
+#ifndef LIST_STREAM_DEFAULT_BUFFER_SIZE
+#define LIST_STREAM_DEFAULT_BUFFER_SIZE 65536
+#endif //LIST_STREAM_DEFAULT_BUFFER_SIZE
+
+/**
+ * @brief Largest record that is accepted when the caller does not specify a
+ * limit.  Guards against a corrupt length prefix causing a huge allocation.
+ */
+#ifndef LIST_STREAM_DEFAULT_MAX_RECORD_SIZE
+#define LIST_STREAM_DEFAULT_MAX_RECORD_SIZE (16 * 1024 * 1024)
+#endif //LIST_STREAM_DEFAULT_MAX_RECORD_SIZE
+
+/**
+ * @brief Number of parsed records that are collected before they are added
+ * to the list.
+ */
+#ifndef LIST_STREAM_BATCH_SIZE
+#define LIST_STREAM_BATCH_SIZE 256
+#endif //LIST_STREAM_BATCH_SIZE
+
+/**
+ * @brief Defines the format of a routine that turns a record read from a
+ * stream into the data of a new list element.
+ * @param pvRecord Address of the record, within the buffer into which the
+ * stream was read.  Neither the delimiter nor the length prefix is included.
+ * The record must not be modified, and it is not valid once the routine
+ * returns, so anything the element needs must be copied out of it.
+ * @param nSize Size, in bytes, of the record.
+ * @param pvContext Address of user data that was passed to the function that
+ * is reading the stream.
+ * @return Address of the data to be pointed to by the new element, or NULL to
+ * skip the record.
+ */
+typedef void* (*LPPARSE_ROUTINE)(const void* pvRecord, int nSize,
+    void* pvContext);
+
+/**
+ * @brief Options that control how a stream is split into records.
+ *
+ * When bLengthPrefixed is FALSE, each record ends with chDelimiter, e.g., a
+ * newline; a final record that is not followed by the delimiter is accepted at
+ * the end of the stream.  When it is TRUE, each record is preceded by its
+ * length, as a four-byte unsigned integer in network byte order.
+ */
+typedef struct _tagSTREAM_OPTIONS {
+  BOOL bLengthPrefixed;
+  char chDelimiter;           // Used only if bLengthPrefixed is FALSE
+  int nBufferSize;            // Zero means LIST_STREAM_DEFAULT_BUFFER_SIZE
+  int nMaxRecordSize;         // Zero means LIST_STREAM_DEFAULT_MAX_RECORD_SIZE
+} STREAM_OPTIONS, *LPSTREAM_OPTIONS;
+
+/**
+ * @name AddElementsFromStream
+ * @brief Reads records from a file descriptor until the end of the stream,
+ * and adds an element to the tail of the linked list for each of them;
+ * creates a new list if the current element pointer is NULL.
+ * @param lppElement Address of the current element pointer.  This value is
+ * reset to point to the tail of the list.
+ * @param fd File descriptor from which to read, in blocking mode.
+ * @param lpfnParse Address of a routine that turns each record into the data
+ * of a new element.
+ * @param pvContext Address of user data to be passed to lpfnParse.
+ * @param lpfnDeallocFunc Address of a routine that deallocates the data of a
+ * parsed record that could not be added to the list because no node could be
+ * allocated for it, or NULL if such data need no deallocation.
+ * @param lpOptions Address of the options that control how the stream is
+ * split into records, or NULL for newline-delimited records.
+ * @return Number of elements that were added, or ERROR if the stream could
+ * not be read, ended part way through a length-prefixed record, contained a
+ * record larger than the limit, or a parsed record could not be added.
+ * @remarks The stream is read in large chunks, and each record is handed to
+ * lpfnParse where it lies in the buffer, without being copied.  The parsed
+ * records are added to the list in batches of LIST_STREAM_BATCH_SIZE, with
+ * AddElementsFromArray.  If an error occurs, the elements that were added
+ * before it are left in the list, and the data of any parsed record that
+ * could not be added have already been passed to lpfnDeallocFunc.  The
+ * descriptor is not closed.
+ */
+int AddElementsFromStream(LPPPOSITION lppElement, int fd,
+    LPPARSE_ROUTINE lpfnParse, void* pvContext,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc, LPSTREAM_OPTIONS lpOptions);
+
+/**
+ * @name AddRootElementsFromStream
+ * @brief Reads records from a file descriptor until the end of the stream,
+ * and adds an element to the tail of the list managed by a root for each of
+ * them.
+ * @param lpRoot Address of the root of the list.
+ * @param fd File descriptor from which to read, in blocking mode.
+ * @param lpfnParse Address of a routine that turns each record into the data
+ * of a new element.
+ * @param pvContext Address of user data to be passed to lpfnParse.
+ * @param lpfnDeallocFunc Address of a routine that deallocates the data of a
+ * parsed record that could not be added to the list, or NULL if such data
+ * need no deallocation.
+ * @param lpOptions Address of the options that control how the stream is
+ * split into records, or NULL for newline-delimited records.
+ * @return Number of elements that were added, or ERROR if the stream could
+ * not be read, ended part way through a length-prefixed record, contained a
+ * record larger than the limit, or a parsed record could not be added.
+ * @remarks Works as AddElementsFromStream does, except that the parsed
+ * records are added to the list with AddRootElementsFromArray.
+ */
+int AddRootElementsFromStream(LPLIST_ROOT lpRoot, int fd,
+    LPPARSE_ROUTINE lpfnParse, void* pvContext,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc, LPSTREAM_OPTIONS lpOptions);
+
+#endif //__LIST_STREAM_H__
@@ -0,0 +1,127 @@
+// lockfree_queue.h - Defines the interface to the LOCKFREE_QUEUE data
+// structure, a multi-producer, multi-consumer FIFO queue that never blocks.
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __LOCKFREE_QUEUE_H__
+#define __LOCKFREE_QUEUE_H__
+
+#include "list_core.h"
+
+/**
+ * @brief Number of retired nodes a thread accumulates before it scans the
+ * hazard pointers of all threads to see which of them can be freed.
+ */
+#ifndef LOCKFREE_QUEUE_RETIRE_THRESHOLD
+#define LOCKFREE_QUEUE_RETIRE_THRESHOLD 64
+#endif //LOCKFREE_QUEUE_RETIRE_THRESHOLD
+
+/**
+ * @brief Structure that encapsulates a node of a LOCKFREE_QUEUE.
+ */
+typedef struct _tagQUEUE_NODE {
+  void* pvData;
+  struct _tagQUEUE_NODE* pNext;
+} QUEUE_NODE, *LPQUEUE_NODE;
+
+/**
+ * @brief Hazard-pointer record.  A thread that operates on the queue claims
+ * a record for the duration of the operation, and publishes in it the
+ * addresses of the nodes it is about to dereference, so that no other thread
+ * frees those nodes in the meantime.  Nodes that have been unlinked from the
+ * queue are kept on the record's retired list until no record refers to them.
+ */
+typedef struct _tagHAZARD_RECORD {
+  LPQUEUE_NODE apHazards[2];
+  int bActive;
+  LPQUEUE_NODE* ppRetired;
+  int nRetiredCount;
+  int nRetiredCapacity;
+  struct _tagHAZARD_RECORD* pNext;
+} HAZARD_RECORD, *LPHAZARD_RECORD;
+
+/**
+ * @brief Structure that serves as the root of a lock-free FIFO queue.
+ *
+ * The queue is a Michael-Scott queue: a singly-linked list with a dummy node
+ * at the head, in which enqueuers and dequeuers only ever race on single
+ * compare-and-swap operations, so that no thread ever waits for another to
+ * release a lock.  Unlinked nodes are reclaimed by means of hazard pointers.
+ * The head and the tail live on separate cache lines, so that producers and
+ * consumers do not contend on the same line.
+ */
+typedef struct _tagLOCKFREE_QUEUE {
+  LPQUEUE_NODE pHead __attribute__((aligned(64)));
+  LPQUEUE_NODE pTail __attribute__((aligned(64)));
+  LPHAZARD_RECORD pHazardRecords __attribute__((aligned(64)));
+} LOCKFREE_QUEUE, *LPLOCKFREE_QUEUE, **LPPLOCKFREE_QUEUE;
+
+/**
+ * @name CreateLockFreeQueue
+ * @brief Allocates a new, empty lock-free queue.
+ * @param lppQueue Address of a pointer that will receive the address of the
+ * new queue.  The pointer is set to NULL if the allocation fails.
+ */
+void CreateLockFreeQueue(LPPLOCKFREE_QUEUE lppQueue);
+
+/**
+ * @name DequeueElement
+ * @brief Removes the element at the head of the queue.
+ * @param lpQueue Address of the queue.
+ * @param ppvData Address of a pointer that receives the address of the data
+ * referred to by the element that was removed.
+ * @return TRUE if an element was removed; FALSE if the queue was empty.
+ * @remarks May be called from any number of threads at once.  Ownership of
+ * the data passes to the caller.
+ */
+BOOL DequeueElement(LPLOCKFREE_QUEUE lpQueue, void** ppvData);
+
+/**
+ * @name DestroyLockFreeQueue
+ * @brief Removes all the elements of the queue and then deallocates the
+ * queue.
+ * @param lppQueue Address of a pointer to the queue to be destroyed.  This
+ * pointer is reset to NULL.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each element
+ * that is still in the queue from the heap.  Supplied by the application.
+ * @remarks No other thread may be using the queue when it is destroyed.
+ */
+void DestroyLockFreeQueue(LPPLOCKFREE_QUEUE lppQueue,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name EnqueueElement
+ * @brief Adds a new element to the tail of the queue.
+ * @param lpQueue Address of the queue.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @return TRUE if the element was added; FALSE if memory could not be
+ * allocated for it.
+ * @remarks May be called from any number of threads at once.
+ */
+BOOL EnqueueElement(LPLOCKFREE_QUEUE lpQueue, void* pvData);
+
+/**
+ * @name IsLockFreeQueueEmpty
+ * @brief Determines whether the queue has no elements.
+ * @param lpQueue Address of the queue.
+ * @return TRUE if the queue was empty at the moment it was checked; FALSE
+ * otherwise.
+ */
+BOOL IsLockFreeQueueEmpty(LPLOCKFREE_QUEUE lpQueue);
+
+#endif //__LOCKFREE_QUEUE_H__
@@ -0,0 +1,145 @@
+// parallel.h - Defines the interface to functions that run the list_core
+// aggregate operations on several threads at once.
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __PARALLEL_H__
+#define __PARALLEL_H__
+
+#include <stdint.h>
+
+#include "list_core.h"
+
+/**
+ * @brief Number of elements in each segment of work when the caller does not
+ * specify a segment size.
+ */
+#ifndef PARALLEL_DEFAULT_SEGMENT_SIZE
+#define PARALLEL_DEFAULT_SEGMENT_SIZE 4096
+#endif //PARALLEL_DEFAULT_SEGMENT_SIZE
+
+/**
+ * @brief Options that control how a parallel operation splits up its work.
+ *
+ * The functions declared in this file take a snapshot of the data pointers of
+ * the list (a single walk of the list), split the snapshot into segments, and
+ * have a set of worker threads claim segments and run the usual callback on
+ * each of their elements.  The calling thread is one of the workers.
+ *
+ * The other workers come from a pool of threads that is started the first
+ * time it is needed, grows to the largest number of threads that any
+ * operation has asked for, and is kept for the operations that follow, so
+ * that repeated passes do not pay for starting threads each time.  One
+ * operation at a time uses the pool; an operation that is started while
+ * another one is using it, e.g., from one of its callbacks, runs on its
+ * calling thread alone.  ShutdownParallelWorkers stops the pool.
+ *
+ * The snapshot is cut into segments of nSegmentSize elements, regardless of
+ * the number of threads.  Each worker adds up the results for the segments it
+ * claims in 64 bits, and the workers' partial results are added up once all
+ * the segments are done.  Since these are integers, the result does not
+ * depend on how the segments were shared out.
+ *
+ * If memory for the snapshot or for the workers' partial results cannot be
+ * allocated, the operation is carried out on the calling thread alone, by
+ * walking the list, so that its result is the same either way.
+ */
+typedef struct _tagPARALLEL_OPTIONS {
+  int nThreadCount;     // Zero means one thread per online processor
+  int nSegmentSize;     // Zero means PARALLEL_DEFAULT_SEGMENT_SIZE
+} PARALLEL_OPTIONS, *LPPARALLEL_OPTIONS;
+
+/**
+ * @name DoForEachParallel
+ * @brief Executes an action for each of the elements of the linked list, on
+ * several threads at once.
+ * @param lpElement Address of any element in the list.
+ * @param lpfnAction Address of a function that specifies the code to run for
+ * each element of the list.  It is called concurrently from several threads,
+ * and so must be thread-safe.
+ * @param lpOptions Address of the options that control how the work is split
+ * up, or NULL to use the defaults.
+ * @remarks The elements are not necessarily visited in list order.  The list
+ * must not be modified while this function is running.
+ */
+void DoForEachParallel(LPPOSITION lpElement, LPACTION_ROUTINE lpfnAction,
+    LPPARALLEL_OPTIONS lpOptions);
+
+/**
+ * @name GetElementCountWhereParallel
+ * @brief Gets the count of all elements in the list for which a user-specified
+ * predicate function returns TRUE, evaluating the predicate on several threads
+ * at once.
+ * @param lpElement Address of any element from the list.
+ * @param lpfnPredicate Address of a thread-safe, user-specified predicate
+ * function.
+ * @param lpOptions Address of the options that control how the work is split
+ * up, or NULL to use the defaults.
+ * @return Count of all the list's elements for which the predicate evaluates
+ * to TRUE.
+ */
+int64_t GetElementCountWhereParallel(LPPOSITION lpElement,
+    LPPREDICATE_ROUTINE lpfnPredicate, LPPARALLEL_OPTIONS lpOptions);
+
+/**
+ * @name ShutdownParallelWorkers
+ * @brief Stops the threads of the pool that the parallel operations use, and
+ * waits for them to exit.
+ * @remarks Call this function, e.g., before unloading the library, once no
+ * parallel operation is running, and not from several threads at once.  A
+ * parallel operation that is started afterwards starts a new pool.
+ */
+void ShutdownParallelWorkers(void);
+
+/**
+ * @name SumElementsParallel
+ * @brief Calculates the sum of a sequence of quantities computed from the
+ * elements of the linked list, computing the terms on several threads at once.
+ * @param lpElement Address of any of the nodes in the linked list.
+ * @param lpfnSumRoutine Address of a thread-safe callback that calculates each
+ * term of the summation.
+ * @param lpOptions Address of the options that control how the work is split
+ * up, or NULL to use the defaults.
+ * @return Result of the summation, accumulated in 64 bits, or -1 if a
+ * required parameter is NULL.
+ */
+int64_t SumElementsParallel(LPPOSITION lpElement,
+    LPSUMMATION_ROUTINE lpfnSumRoutine, LPPARALLEL_OPTIONS lpOptions);
+
+/**
+ * @name SumElementsWhereParallel
+ * @brief Calculates the sum of a sequence of quantities computed from those
+ * elements of the linked list that match the criteria provided by the compare
+ * routine, on several threads at once.
+ * @param lpElement Address of any of the nodes in the linked list.
+ * @param lpfnSumRoutine Address of a thread-safe callback that calculates each
+ * term of the summation.
+ * @param pvSearchKey Address of user data that is to be utilized as a search
+ * key to check whether elements meet the criteria for being included in the
+ * summation.
+ * @param lpfnCompareRoutine Address of a thread-safe callback that provides
+ * the criteria by which elements are to be included or excluded.
+ * @param lpOptions Address of the options that control how the work is split
+ * up, or NULL to use the defaults.
+ * @return Result of the summation, accumulated in 64 bits, or -1 if a
+ * required parameter is NULL.  Returns zero if nothing is included in the sum.
+ */
+int64_t SumElementsWhereParallel(LPPOSITION lpElement,
+    LPSUMMATION_ROUTINE lpfnSumRoutine, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareRoutine, LPPARALLEL_OPTIONS lpOptions);
+
+#endif //__PARALLEL_H__
@@ -40,7 +40,8 @@ typedef struct _tagPOSITION {
  * @brief Creates a new POSITION structure instance and returns a reference to
  * it.
  * @param lppPosition Address of a pointer that will receive the address of the
- * newly-allocated POSITION instance.
+ * newly-allocated POSITION instance.  The pointer is set to NULL if the
+ * allocation fails.
  */
 void CreatePosition(LPPPOSITION lppPosition);
 
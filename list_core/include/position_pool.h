@@ -0,0 +1,153 @@
+// position_pool.h - Defines the interface to the POSITION_POOL data structure,
+// a slab allocator for POSITION nodes.
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __POSITION_POOL_H__
+#define __POSITION_POOL_H__
+
+#include <pthread.h>
+
+#include "position.h"
+
+/**
+ * @brief Number of POSITION nodes carved out of each slab when the caller
+ * does not specify a slab size.
+ */
+#ifndef POSITION_POOL_DEFAULT_SLAB_SIZE
+#define POSITION_POOL_DEFAULT_SLAB_SIZE 1024
+#endif //POSITION_POOL_DEFAULT_SLAB_SIZE
+
+/**
+ * @brief Allocation statistics maintained by a POSITION_POOL.
+ */
+typedef struct _tagPOSITION_POOL_STATS {
+  long nSlabCount;           // Number of slabs currently held by the pool
+  long nSlabBytes;           // Total bytes currently held in slabs
+  long nTotalAllocations;    // Nodes handed out over the life of the pool
+  long nTotalFrees;          // Nodes given back over the life of the pool
+  long nActivePositions;     // Nodes currently handed out
+  long nPeakActivePositions; // High-water mark of nActivePositions
+  long nFreeListLength;      // Nodes waiting on the free list to be recycled
+} POSITION_POOL_STATS, *LPPOSITION_POOL_STATS;
+
+/**
+ * @brief A slab of contiguous POSITION nodes owned by a POSITION_POOL.
+ */
+typedef struct _tagPOSITION_SLAB {
+  struct _tagPOSITION_SLAB* pNext;
+  int nCapacity;
+  int nUsed;
+  POSITION aPositions[];
+} POSITION_SLAB, *LPPOSITION_SLAB;
+
+/**
+ * @brief Structure that encapsulates a pool of POSITION nodes.
+ *
+ * Nodes are carved out of large slabs, and nodes that are given back to the
+ * pool are recycled through a free list, so that, under churn, adding and
+ * removing list elements does not call malloc() and free() once per node.
+ * A pool may be dedicated to a single list, or shared between several; a pool
+ * that is shared between threads must be created as thread-safe.
+ */
+typedef struct _tagPOSITION_POOL {
+  LPPOSITION_SLAB pSlabs;
+  LPPOSITION pFreeList;
+  int nSlabSize;
+  BOOL bThreadSafe;
+  pthread_mutex_t mutex;
+  POSITION_POOL_STATS stats;
+} POSITION_POOL, *LPPOSITION_POOL, **LPPPOSITION_POOL;
+
+/**
+ * @name AllocPoolPosition
+ * @brief Obtains a zero-initialized POSITION node from the pool.
+ * @param lpPool Address of the pool from which to allocate the node.
+ * @param lppPosition Address of a pointer that will receive the address of the
+ * node.  The pointer is set to NULL if the allocation fails.
+ */
+void AllocPoolPosition(LPPOSITION_POOL lpPool, LPPPOSITION lppPosition);
+
+/**
+ * @name AllocPoolPositions
+ * @brief Obtains a block of contiguous POSITION nodes from the pool.
+ * @param lpPool Address of the pool from which to allocate the nodes.
+ * @param nCount Number of nodes to allocate.
+ * @param lppPositions Address of a pointer that will receive the address of
+ * the first node of the block.  The pointer is set to NULL if the allocation
+ * fails.
+ * @remarks The nodes are carved out of a single slab, so that they are adjacent
+ * in memory; the free list is not consulted.  The nodes are not initialized;
+ * the caller is expected to set every member of each of them.  Each node may
+ * later be given back to the pool individually with FreePoolPosition.
+ */
+void AllocPoolPositions(LPPOSITION_POOL lpPool, int nCount,
+    LPPPOSITION lppPositions);
+
+/**
+ * @name CreatePositionPool
+ * @brief Allocates a new, empty pool of POSITION nodes.
+ * @param lppPool Address of a pointer that will receive the address of the
+ * new pool.  The pointer is set to NULL if the allocation fails.
+ * @param nSlabSize Number of nodes to carve out of each slab.  Specify zero
+ * to use POSITION_POOL_DEFAULT_SLAB_SIZE.
+ * @param bThreadSafe TRUE if the pool is to be shared between threads, in
+ * which case every operation on it is serialized by a mutex; FALSE otherwise.
+ */
+void CreatePositionPool(LPPPOSITION_POOL lppPool, int nSlabSize,
+    BOOL bThreadSafe);
+
+/**
+ * @name DestroyPositionPool
+ * @brief Releases all the slabs held by the pool, and then the pool itself.
+ * @param lppPool Address of a pointer to the pool to be destroyed.  This
+ * pointer is reset to NULL.
+ * @remarks Every node that was allocated from the pool becomes invalid,
+ * whether or not it was given back to the pool first.
+ */
+void DestroyPositionPool(LPPPOSITION_POOL lppPool);
+
+/**
+ * @name FreePoolPosition
+ * @brief Gives a node back to the pool from which it was allocated, so that
+ * it may be recycled.
+ * @param lpPool Address of the pool from which the node was allocated.
+ * @param lppPosition Address of a pointer to the node.  This pointer is reset
+ * to NULL.
+ */
+void FreePoolPosition(LPPOSITION_POOL lpPool, LPPPOSITION lppPosition);
+
+/**
+ * @name GetPositionPoolStats
+ * @brief Retrieves a copy of the pool's allocation statistics.
+ * @param lpPool Address of the pool whose statistics are to be retrieved.
+ * @param lpStats Address of a structure that receives the statistics.
+ */
+void GetPositionPoolStats(LPPOSITION_POOL lpPool,
+    LPPOSITION_POOL_STATS lpStats);
+
+/**
+ * @name ResetPositionPool
+ * @brief Releases every node allocated from the pool in one shot, by freeing
+ * all of the pool's slabs.
+ * @param lpPool Address of the pool to be reset.
+ * @remarks Every node that was allocated from the pool becomes invalid.  The
+ * pool itself remains usable, and allocates new slabs on demand.
+ */
+void ResetPositionPool(LPPOSITION_POOL lpPool);
+
+#endif /* __POSITION_POOL_H__ */
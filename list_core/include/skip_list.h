@@ -0,0 +1,187 @@
+// skip_list.h - Defines the interface to the SKIP_LIST data structure, a
+// linked list that is kept in order and can be searched in logarithmic time.
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __SKIP_LIST_H__
+#define __SKIP_LIST_H__
+
+#include "list_core.h"
+
+/**
+ * @brief Maximum height of the tower of any node.  Each level holds about a
+ * quarter of the nodes of the level below it, so sixteen levels are enough
+ * for lists of up to about four billion elements.
+ */
+#define SKIP_LIST_MAX_LEVEL 16
+
+/**
+ * @brief Structure that encapsulates a node of a SKIP_LIST.
+ *
+ * The node begins with an ordinary POSITION, and the POSITIONs of all the
+ * nodes are linked together in order, so the address of any node may be
+ * passed to those functions declared in list_core.h that do not add or remove
+ * elements.  The node's tower of forward pointers, one per level, follows.
+ */
+typedef struct _tagSKIP_NODE {
+  POSITION position;
+  int nLevel;
+  struct _tagSKIP_NODE* apForward[];
+} SKIP_NODE, *LPSKIP_NODE;
+
+/**
+ * @brief Structure that serves as the root of a skip list.
+ *
+ * A skip list is a linked list that is kept sorted according to a comparison
+ * routine supplied when the list is created.  Besides the link to its
+ * successor, each node has, with probability 1/4, a link to the next node
+ * one level up, and so on, so that searches can skip over long stretches of
+ * the list.  Searching, adding and removing elements take O(log N) expected
+ * time.  Elements that compare equal are kept in the order in which they were
+ * added.
+ */
+typedef struct _tagSKIP_LIST {
+  LPSKIP_NODE pHeader;        // Sentinel whose tower has every level
+  int nLevel;                 // Number of levels currently in use
+  int nCount;
+  LPSORT_COMPARE_ROUTINE lpfnCompare;
+  unsigned int nRandomState;  // Drives the choice of each node's height
+} SKIP_LIST, *LPSKIP_LIST, **LPPSKIP_LIST;
+
+/**
+ * @name AddSkipListElement
+ * @brief Adds a new element to the list, in order.
+ * @param lpList Address of the list.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @return Address of the newly-added element, or NULL if the element could
+ * not be added.
+ * @remarks The new element is placed after any elements that are equivalent
+ * to it.
+ */
+LPPOSITION AddSkipListElement(LPSKIP_LIST lpList, void* pvData);
+
+/**
+ * @name ClearSkipList
+ * @brief Removes and deallocates all the elements from the list, leaving the
+ * list itself intact and empty.
+ * @param lpList Address of the list.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each node from
+ * the heap.  Supplied by the application.
+ */
+void ClearSkipList(LPSKIP_LIST lpList, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name CreateSkipList
+ * @brief Allocates a new, empty skip list.
+ * @param lppList Address of a pointer that will receive the address of the
+ * new list.  The pointer is set to NULL if the allocation fails.
+ * @param lpfnCompare Address of a callback that determines the relative order
+ * of the data of two elements.  It is also called with an element's data as
+ * its first argument and a search key as its second, so a search key must be
+ * something that the routine can compare with the data of an element.
+ */
+void CreateSkipList(LPPSKIP_LIST lppList, LPSORT_COMPARE_ROUTINE lpfnCompare);
+
+/**
+ * @name DestroySkipList
+ * @brief Removes all the elements of the list and then deallocates the list.
+ * @param lppList Address of a pointer to the list to be destroyed.  This
+ * pointer is reset to NULL.
+ * @param lpfnDeallocFunc Address of a function that implements specialized
+ * deallocation logic to properly remove the data referred to by each node from
+ * the heap.  Supplied by the application.
+ */
+void DestroySkipList(LPPSKIP_LIST lppList, LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name DoForEachSkipListElementInRange
+ * @brief Executes an action for each of the elements of the list that lie
+ * within a range of keys, in order.
+ * @param lpList Address of the list.
+ * @param pvLowKey Address of the smallest key in the range, inclusive, or
+ * NULL to start from the head of the list.
+ * @param pvHighKey Address of the largest key in the range, inclusive, or
+ * NULL to carry on to the tail of the list.
+ * @param lpfnAction Address of a function that specifies the code to run for
+ * each element in the range.
+ * @remarks The first element of the range is located in O(log N) expected
+ * time; from there, only the elements in the range are visited.
+ */
+void DoForEachSkipListElementInRange(LPSKIP_LIST lpList, void* pvLowKey,
+    void* pvHighKey, LPACTION_ROUTINE lpfnAction);
+
+/**
+ * @name FindSkipListElement
+ * @brief Locates the first element whose data is equivalent to the search
+ * key.
+ * @param lpList Address of the list.
+ * @param pvSearchKey Address of data to serve as a lookup key.
+ * @return Address of the matching element, or NULL if not found.
+ * @remarks This operation takes O(log N) expected time.
+ */
+LPPOSITION FindSkipListElement(LPSKIP_LIST lpList, void* pvSearchKey);
+
+/**
+ * @name GetSkipListElementCount
+ * @brief Gets the count of the elements in the list.
+ * @param lpList Address of the list.
+ * @return Count of elements in the list, or zero if lpList is NULL.
+ */
+int GetSkipListElementCount(LPSKIP_LIST lpList);
+
+/**
+ * @name GetSkipListHead
+ * @brief Gets the address of the first element of the list.
+ * @param lpList Address of the list.
+ * @return Address of the head element, or NULL if the list is empty.
+ * @remarks The elements that follow can be reached through the pNext links of
+ * the POSITIONs, in order.
+ */
+LPPOSITION GetSkipListHead(LPSKIP_LIST lpList);
+
+/**
+ * @name RemoveSkipListElement
+ * @brief Removes the specified element from the list.
+ * @param lpList Address of the list.
+ * @param lpElement Address of the element to be removed.  The element must
+ * belong to the list.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data the node
+ * refers to from the heap.
+ * @return Address of the element that followed the removed element, or NULL
+ * if the removed element was the tail.
+ */
+LPPOSITION RemoveSkipListElement(LPSKIP_LIST lpList, LPPOSITION lpElement,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name RemoveSkipListElementWhere
+ * @brief Removes all elements from the list whose data is equivalent to the
+ * search key.
+ * @param lpList Address of the list.
+ * @param pvSearchKey Address of data to be used as a key in the search for
+ * which elements to delete.
+ * @param lpfnDeallocFunc Address of a callback that implements application-
+ * specific deallocation functionality to properly remove the data each node
+ * refers to from the heap.
+ * @return Number of elements that were removed from the list.
+ */
+int RemoveSkipListElementWhere(LPSKIP_LIST lpList, void* pvSearchKey,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+#endif //__SKIP_LIST_H__
@@ -0,0 +1,232 @@
+// versioned_list.h - Defines the interface to the VERSIONED_LIST data
+// structure, a list that readers can scan through a consistent, unchanging
+// view while writers keep adding and removing elements
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __VERSIONED_LIST_H__
+#define __VERSIONED_LIST_H__
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "list_core.h"
+
+/**
+ * @brief Node of a VERSIONED_LIST.
+ *
+ * Each node records the version of the list in which its element was added,
+ * and the version in which it was removed, if it has been.  An element is
+ * part of version v of the list if nBirth <= v < nDeath.
+ */
+typedef struct _tagVERSIONED_NODE {
+  void* pvData;
+  struct _tagVERSIONED_NODE* pNext;
+  uint64_t nBirth;            // Version in which the element was added
+  uint64_t nDeath;            // Version in which it was removed, or UINT64_MAX
+  uint64_t nRetired;          // See VERSIONED_LIST; zero while linked
+  struct _tagVERSIONED_NODE* pNextRetired;
+} VERSIONED_NODE, *LPVERSIONED_NODE;
+
+/**
+ * @brief Consistent, read-only view of a VERSIONED_LIST as of one version.
+ */
+typedef struct _tagLIST_VIEW {
+  struct _tagVERSIONED_LIST* lpList;
+  uint64_t nVersion;          // Version of the list that the view shows
+  uint64_t nSequence;         // Order in which the view was opened
+  struct _tagLIST_VIEW* pPrev;
+  struct _tagLIST_VIEW* pNext;
+} LIST_VIEW, *LPLIST_VIEW, **LPPLIST_VIEW;
+
+/**
+ * @brief Structure that serves as the root of a versioned list.
+ *
+ * Every change a writer makes to the list creates a new version of it.  A
+ * reader opens a LIST_VIEW, which shows the list as of the latest version at
+ * that time, for as long as the view stays open: elements that are added
+ * later are not part of it, and elements that are removed later still are.
+ * Readers therefore never take the writers' lock, nor copy the list, and a
+ * long scan neither blocks nor is disturbed by writers.
+ *
+ * Writers are serialized by a mutex.  An element that is removed stays in the
+ * list, marked with the version in which it was removed, until no open view
+ * can see it; it is then unlinked.  Since a reader may still be walking
+ * through a node that has just been unlinked, the node is retired rather than
+ * freed, stamped with the sequence number of the next view to be opened, and
+ * it is only freed, along with its data, once every view that was open at the
+ * time has been closed.  This happens as writers make further changes, or
+ * when ReclaimVersionedList is called.  Since stamps never decrease, the
+ * retired nodes are kept in the order of their stamps, and a writer only
+ * looks at those that it can free, plus one.
+ */
+typedef struct _tagVERSIONED_LIST {
+  LPVERSIONED_NODE pHead;
+  LPVERSIONED_NODE pTail;
+  int nCount;                 // Elements in the latest version
+  uint64_t nVersion;          // Latest version
+  LPDEALLOC_ROUTINE lpfnDeallocFunc;
+  pthread_mutex_t writeMutex; // Serializes the writers
+  LPVERSIONED_NODE pRetired;  // Unlinked nodes that may not be freed yet
+  LPVERSIONED_NODE pRetiredTail;
+  pthread_mutex_t viewMutex;  // Protects the members that follow
+  LPLIST_VIEW pOldestView;    // Open views, oldest first
+  LPLIST_VIEW pNewestView;
+  uint64_t nNextSequence;
+} VERSIONED_LIST, *LPVERSIONED_LIST, **LPPVERSIONED_LIST;
+
+/**
+ * @name AddVersionedElement
+ * @brief Adds a new element to the tail of the list, creating a new version.
+ * @param lpList Address of the list.
+ * @param pvData Address of data to be pointed to by the new element.
+ * @return TRUE if the element was added; FALSE if memory could not be
+ * allocated for it.
+ * @remarks Views that are already open do not include the new element.
+ */
+BOOL AddVersionedElement(LPVERSIONED_LIST lpList, void* pvData);
+
+/**
+ * @name CloseListView
+ * @brief Closes a view of a versioned list.
+ * @param lppView Address of a pointer to the view.  This pointer is reset to
+ * NULL.
+ * @remarks Elements that were removed from the list while the view was open
+ * may be deallocated as soon as the view is closed, by the next writer.
+ */
+void CloseListView(LPPLIST_VIEW lppView);
+
+/**
+ * @name CreateVersionedList
+ * @brief Allocates a new, empty versioned list.
+ * @param lppList Address of a pointer that will receive the address of the
+ * new list.  The pointer is set to NULL if the allocation fails.
+ * @param lpfnDeallocFunc Address of a function that deallocates the data of
+ * an element once the element has been removed and no view can see it any
+ * more.  Since this may happen some time after the removal, on whichever
+ * thread is writing to the list then, the function is given to the list once
+ * rather than to each call that removes elements.  Pass DeallocateNothing if
+ * the list does not own the data.
+ */
+void CreateVersionedList(LPPVERSIONED_LIST lppList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc);
+
+/**
+ * @name DestroyVersionedList
+ * @brief Deallocates all the elements of the list, and then the list itself.
+ * @param lppList Address of a pointer to the list to be destroyed.  This
+ * pointer is reset to NULL.
+ * @remarks Every view of the list must have been closed first.
+ */
+void DestroyVersionedList(LPPVERSIONED_LIST lppList);
+
+/**
+ * @name DoForEachViewElement
+ * @brief Executes an action for each of the elements in a view of a list, in
+ * order.
+ * @param lpView Address of the view.
+ * @param lpfnAction Address of a function that specifies the code to run for
+ * each element.  It must not modify the data, which other views may share.
+ */
+void DoForEachViewElement(LPLIST_VIEW lpView, LPACTION_ROUTINE lpfnAction);
+
+/**
+ * @name FindViewElement
+ * @brief Locates the first element in a view of a list that matches the
+ * search key according to the specified comparison routine.
+ * @param lpView Address of the view.
+ * @param pvSearchKey Address of data to serve as a lookup key.
+ * @param lpfnCompare User-specified routine that determines whether the data
+ * of a given element matches the key.
+ * @return Address of the data of the matching element, or NULL if not found.
+ * The data remain valid until the view is closed.
+ */
+void* FindViewElement(LPLIST_VIEW lpView, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompare);
+
+/**
+ * @name FindViewElementWhere
+ * @brief Locates the first element in a view of a list for which the
+ * specified predicate function evaluates to TRUE.
+ * @param lpView Address of the view.
+ * @param lpfnPredicate Address of a user-specified predicate routine.
+ * @return Address of the data of the matching element, or NULL if not found.
+ * The data remain valid until the view is closed.
+ */
+void* FindViewElementWhere(LPLIST_VIEW lpView,
+    LPPREDICATE_ROUTINE lpfnPredicate);
+
+/**
+ * @name GetVersionedElementCount
+ * @brief Gets the count of the elements in the latest version of the list.
+ * @param lpList Address of the list.
+ * @return Count of elements, or zero if lpList is NULL.
+ * @remarks This operation takes constant time.
+ */
+int GetVersionedElementCount(LPVERSIONED_LIST lpList);
+
+/**
+ * @name GetViewElementCount
+ * @brief Gets the count of the elements in a view of a list.
+ * @param lpView Address of the view.
+ * @return Count of elements, or zero if lpView is NULL.
+ * @remarks The view is walked in order to count its elements.
+ */
+int GetViewElementCount(LPLIST_VIEW lpView);
+
+/**
+ * @name OpenListView
+ * @brief Opens a view of the latest version of a versioned list.
+ * @param lpList Address of the list.
+ * @param lppView Address of a pointer that will receive the address of the
+ * view.  The pointer is set to NULL if the allocation fails.
+ * @remarks Opening a view does not wait for writers.  A view should not be
+ * kept open for longer than it is needed, since the elements that are removed
+ * while it is open cannot be deallocated until it is closed.  A view may be
+ * used by one thread at a time.
+ */
+void OpenListView(LPVERSIONED_LIST lpList, LPPLIST_VIEW lppView);
+
+/**
+ * @name ReclaimVersionedList
+ * @brief Unlinks the removed elements that no open view can see any more, and
+ * deallocates those that no open view can be walking through.
+ * @param lpList Address of the list.
+ * @return Number of elements that were deallocated.
+ * @remarks Writers do this as they go; call this function to release memory
+ * promptly after long-lived views have been closed, when no writes are
+ * expected for a while.
+ */
+int ReclaimVersionedList(LPVERSIONED_LIST lpList);
+
+/**
+ * @name RemoveVersionedElementWhere
+ * @brief Removes all the elements from the list that match the search key
+ * according to the specified comparison routine, creating a new version.
+ * @param lpList Address of the list.
+ * @param pvSearchKey Address of data to be used as a key in the search for
+ * which elements to remove.
+ * @param lpfnCompareFunc Address of a callback provided by the application
+ * that determines whether an element matches the key.
+ * @return Number of elements that were removed.
+ * @remarks Views that are already open still include the removed elements,
+ * whose data are only deallocated once no such view remains.
+ */
+int RemoveVersionedElementWhere(LPVERSIONED_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareFunc);
+
+#endif //__VERSIONED_LIST_H__
@@ -0,0 +1,421 @@
+// chunked_list.c - Implementations of functions that provide the
+// functionality of an unrolled linked list
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "chunked_list.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AppendListChunk function - Allocates a new, empty chunk and links it after
+// the tail of the list.
+
+static LPLIST_CHUNK AppendListChunk(LPCHUNKED_LIST lpList) {
+  void* pvChunk = NULL;
+  if (posix_memalign(&pvChunk, LIST_CHUNK_ALIGNMENT,
+      sizeof(LIST_CHUNK)) != 0) {
+    return NULL;
+  }
+
+  LPLIST_CHUNK lpChunk = (LPLIST_CHUNK) pvChunk;
+
+  lpChunk->nCount = 0;
+  lpChunk->pNext = NULL;
+  lpChunk->pPrev = lpList->pTail;
+
+  if (lpList->pTail != NULL) {
+    lpList->pTail->pNext = lpChunk;
+  } else {
+    lpList->pHead = lpChunk;
+  }
+  lpList->pTail = lpChunk;
+
+  return lpChunk;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveChunkedElementsWhere function - Walks the list once, deallocating
+// each element that matches either the search key (according to lpfnCompare)
+// or the predicate, whichever one is specified, while packing the survivors
+// toward the head.  Chunks left empty at the end are freed.
+
+static int RemoveChunkedElementsWhere(LPCHUNKED_LIST lpList,
+    void* pvSearchKey, LPCOMPARE_ROUTINE lpfnCompare,
+    LPPREDICATE_ROUTINE lpfnPredicate, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  int nRemoved = 0;
+
+  LPLIST_CHUNK lpWrite = lpList->pHead;
+  int nWrite = 0;
+
+  for (LPLIST_CHUNK lpRead = lpList->pHead; lpRead != NULL;
+      lpRead = lpRead->pNext) {
+    for (int i = 0; i < lpRead->nCount; i++) {
+      void* pvData = lpRead->apvData[i];
+
+      BOOL bMatch = lpfnCompare != NULL
+          ? lpfnCompare(pvSearchKey, pvData)
+          : lpfnPredicate(pvData);
+      if (bMatch) {
+        lpfnDeallocFunc(pvData);
+        nRemoved++;
+        continue;
+      }
+
+      /* The write cursor never overtakes the read cursor, so a full
+       write chunk is always one that has already been read. */
+      if (nWrite == LIST_CHUNK_CAPACITY) {
+        lpWrite->nCount = nWrite;
+        lpWrite = lpWrite->pNext;
+        nWrite = 0;
+      }
+      lpWrite->apvData[nWrite++] = pvData;
+    }
+  }
+
+  if (nRemoved == 0) {
+    return nRemoved;
+  }
+
+  lpWrite->nCount = nWrite;
+
+  LPLIST_CHUNK lpFirstUnused = lpWrite->pNext;
+  if (nWrite == 0) {
+    lpFirstUnused = lpWrite;
+  }
+
+  lpList->pTail = lpFirstUnused->pPrev;
+  if (lpList->pTail != NULL) {
+    lpList->pTail->pNext = NULL;
+  } else {
+    lpList->pHead = NULL;
+  }
+
+  while (lpFirstUnused != NULL) {
+    LPLIST_CHUNK lpNext = lpFirstUnused->pNext;
+    free(lpFirstUnused);
+    lpFirstUnused = lpNext;
+  }
+
+  lpList->nCount -= nRemoved;
+
+  return nRemoved;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AddChunkedElement function
+
+BOOL AddChunkedElement(LPCHUNKED_LIST lpList, void* pvData) {
+  if (lpList == NULL) {
+    return FALSE; // Required parameter
+  }
+
+  LPLIST_CHUNK lpChunk = lpList->pTail;
+  if (lpChunk == NULL || lpChunk->nCount == LIST_CHUNK_CAPACITY) {
+    lpChunk = AppendListChunk(lpList);
+    if (lpChunk == NULL) {
+      fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+      return FALSE;
+    }
+  }
+
+  lpChunk->apvData[lpChunk->nCount++] = pvData;
+  lpList->nCount++;
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ClearChunkedList function
+
+void ClearChunkedList(LPCHUNKED_LIST lpList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpList == NULL) {
+    return; // Required parameter
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  LPLIST_CHUNK lpChunk = lpList->pHead;
+  while (lpChunk != NULL) {
+    LPLIST_CHUNK lpNext = lpChunk->pNext;
+    for (int i = 0; i < lpChunk->nCount; i++) {
+      lpfnDeallocFunc(lpChunk->apvData[i]);
+    }
+    free(lpChunk);
+    lpChunk = lpNext;
+  }
+
+  lpList->pHead = NULL;
+  lpList->pTail = NULL;
+  lpList->nCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateChunkedList function
+
+void CreateChunkedList(LPPCHUNKED_LIST lppList) {
+  if (lppList == NULL) {
+    return; // Required parameter
+  }
+
+  *lppList = (LPCHUNKED_LIST) malloc(sizeof(CHUNKED_LIST));
+  if (*lppList == NULL) {
+    fprintf(stderr, FAILED_ALLOC_LIST);
+    return;
+  }
+
+  memset(*lppList, 0, sizeof(CHUNKED_LIST));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateChunkedListFromPositions function
+
+void CreateChunkedListFromPositions(LPPCHUNKED_LIST lppList,
+    LPPOSITION lpElement) {
+  if (lppList == NULL) {
+    return; // Required parameter
+  }
+
+  CreateChunkedList(lppList);
+  if (*lppList == NULL) {
+    return;
+  }
+
+  MoveToHeadPosition(&lpElement);
+
+  for (; lpElement != NULL; lpElement = lpElement->pNext) {
+    if (!AddChunkedElement(*lppList, lpElement->pvData)) {
+      DestroyChunkedList(lppList, DeallocateNothing);
+      return;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DestroyChunkedList function
+
+void DestroyChunkedList(LPPCHUNKED_LIST lppList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppList == NULL || *lppList == NULL) {
+    return; // Nothing to do
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  ClearChunkedList(*lppList, lpfnDeallocFunc);
+
+  free(*lppList);
+  *lppList = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DoForEachChunkedElement function
+
+void DoForEachChunkedElement(LPCHUNKED_LIST lpList,
+    LPACTION_ROUTINE lpfnAction) {
+  if (lpList == NULL || lpfnAction == NULL) {
+    return;
+  }
+
+  for (LPLIST_CHUNK lpChunk = lpList->pHead; lpChunk != NULL;
+      lpChunk = lpChunk->pNext) {
+    for (int i = 0; i < lpChunk->nCount; i++) {
+      lpfnAction(lpChunk->apvData[i]);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindChunkedElement function
+
+void* FindChunkedElement(LPCHUNKED_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompare) {
+  if (lpList == NULL || lpfnCompare == NULL) {
+    return NULL;  // Required parameters
+  }
+
+  for (LPLIST_CHUNK lpChunk = lpList->pHead; lpChunk != NULL;
+      lpChunk = lpChunk->pNext) {
+    for (int i = 0; i < lpChunk->nCount; i++) {
+      if (lpfnCompare(pvSearchKey, lpChunk->apvData[i])) {
+        return lpChunk->apvData[i];
+      }
+    }
+  }
+
+  return NULL;  // If we get here, no element's data meets the criteria
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindChunkedElementWhere function
+
+void* FindChunkedElementWhere(LPCHUNKED_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate) {
+  if (lpList == NULL || lpfnPredicate == NULL) {
+    return NULL;  // Required parameters
+  }
+
+  for (LPLIST_CHUNK lpChunk = lpList->pHead; lpChunk != NULL;
+      lpChunk = lpChunk->pNext) {
+    for (int i = 0; i < lpChunk->nCount; i++) {
+      if (lpfnPredicate(lpChunk->apvData[i])) {
+        return lpChunk->apvData[i];
+      }
+    }
+  }
+
+  return NULL;  // If we get here, no element's data meets the criteria
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetChunkedElementCount function
+
+int GetChunkedElementCount(LPCHUNKED_LIST lpList) {
+  if (lpList == NULL) {
+    return 0;
+  }
+
+  return lpList->nCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetChunkedElementCountWhere function
+
+int GetChunkedElementCountWhere(LPCHUNKED_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate) {
+  int nResult = 0;
+  if (lpList == NULL || lpfnPredicate == NULL) {
+    return nResult;
+  }
+
+  for (LPLIST_CHUNK lpChunk = lpList->pHead; lpChunk != NULL;
+      lpChunk = lpChunk->pNext) {
+    for (int i = 0; i < lpChunk->nCount; i++) {
+      if (lpfnPredicate(lpChunk->apvData[i]))
+        nResult++;
+    }
+  }
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveChunkedElementWhere function
+
+int RemoveChunkedElementWhere(LPCHUNKED_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareFunc, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpList == NULL || lpList->pHead == NULL) {
+    return 0; // Nothing to do
+  }
+
+  if (lpfnCompareFunc == NULL || lpfnDeallocFunc == NULL) {
+    return 0; // Required parameters
+  }
+
+  return RemoveChunkedElementsWhere(lpList, pvSearchKey, lpfnCompareFunc,
+      NULL, lpfnDeallocFunc);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveChunkedElementWherePredicate function
+
+int RemoveChunkedElementWherePredicate(LPCHUNKED_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpList == NULL || lpList->pHead == NULL) {
+    return 0; // Nothing to do
+  }
+
+  if (lpfnPredicate == NULL || lpfnDeallocFunc == NULL) {
+    return 0; // Required parameters
+  }
+
+  return RemoveChunkedElementsWhere(lpList, NULL, NULL, lpfnPredicate,
+      lpfnDeallocFunc);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumChunkedElements function
+
+int SumChunkedElements(LPCHUNKED_LIST lpList,
+    LPSUMMATION_ROUTINE lpfnSumRoutine) {
+  if (lpList == NULL || lpfnSumRoutine == NULL) {
+    return ERROR;  // Required parameters
+  }
+
+  int nResult = 0;
+
+  for (LPLIST_CHUNK lpChunk = lpList->pHead; lpChunk != NULL;
+      lpChunk = lpChunk->pNext) {
+    for (int i = 0; i < lpChunk->nCount; i++) {
+      nResult += lpfnSumRoutine(lpChunk->apvData[i]);
+    }
+  }
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumChunkedElementsWhere function
+
+int SumChunkedElementsWhere(LPCHUNKED_LIST lpList,
+    LPSUMMATION_ROUTINE lpfnSumRoutine, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareRoutine) {
+  int nResult = 0;
+
+  if (lpList == NULL) {
+    return nResult; // No elements at all; sum is obviously 0
+  }
+
+  if (lpfnSumRoutine == NULL) {
+    return ERROR; // Required parameter
+  }
+
+  if (pvSearchKey == NULL) {
+    return ERROR; // Required parameter
+  }
+
+  if (lpfnCompareRoutine == NULL) {
+    return ERROR; // Required parameter
+  }
+
+  for (LPLIST_CHUNK lpChunk = lpList->pHead; lpChunk != NULL;
+      lpChunk = lpChunk->pNext) {
+    for (int i = 0; i < lpChunk->nCount; i++) {
+      void* pvData = lpChunk->apvData[i];
+      if (!lpfnCompareRoutine(pvSearchKey, pvData)) {
+        continue; // Skip elements for which criteria is not met
+      }
+      nResult += lpfnSumRoutine(pvData);
+    }
+  }
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
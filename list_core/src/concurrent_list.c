@@ -0,0 +1,283 @@
+// concurrent_list.c - Implementations of functions that provide the
+// functionality of a linked list that may be used from several threads at once
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "list_root.h"
+#include "concurrent_list.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AddConcurrentElement function
+
+BOOL AddConcurrentElement(LPCONCURRENT_LIST lpList, void* pvData) {
+  if (lpList == NULL) {
+    return FALSE; // Required parameter
+  }
+
+  unsigned int nTicket = (unsigned int) __atomic_fetch_add(
+      &(lpList->nNextStripe), 1, __ATOMIC_RELAXED);
+  LPCONCURRENT_STRIPE lpStripe =
+      &(lpList->pStripes[nTicket % (unsigned int) lpList->nStripeCount]);
+
+  pthread_rwlock_wrlock(&(lpStripe->lock));
+
+  LPPOSITION lpNew = AddRootElementToTail(lpStripe->lpRoot, pvData);
+
+  pthread_rwlock_unlock(&(lpStripe->lock));
+
+  return lpNew != NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ClearConcurrentList function
+
+void ClearConcurrentList(LPCONCURRENT_LIST lpList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpList == NULL || lpfnDeallocFunc == NULL) {
+    return; // Required parameters
+  }
+
+  for (int i = 0; i < lpList->nStripeCount; i++) {
+    LPCONCURRENT_STRIPE lpStripe = &(lpList->pStripes[i]);
+
+    pthread_rwlock_wrlock(&(lpStripe->lock));
+    ClearListRoot(lpStripe->lpRoot, lpfnDeallocFunc);
+    pthread_rwlock_unlock(&(lpStripe->lock));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateConcurrentList function
+
+void CreateConcurrentList(LPPCONCURRENT_LIST lppList, int nStripeCount) {
+  if (lppList == NULL) {
+    return; // Required parameter
+  }
+
+  if (nStripeCount <= 0) {
+    nStripeCount = CONCURRENT_LIST_DEFAULT_STRIPES;
+  }
+
+  *lppList = (LPCONCURRENT_LIST) malloc(sizeof(CONCURRENT_LIST));
+  if (*lppList == NULL) {
+    fprintf(stderr, FAILED_ALLOC_LIST);
+    return;
+  }
+
+  memset(*lppList, 0, sizeof(CONCURRENT_LIST));
+
+  void* pvStripes = NULL;
+  if (posix_memalign(&pvStripes, __alignof__(CONCURRENT_STRIPE),
+      nStripeCount * sizeof(CONCURRENT_STRIPE)) != 0) {
+    fprintf(stderr, FAILED_ALLOC_LIST_STORAGE);
+    free(*lppList);
+    *lppList = NULL;
+    return;
+  }
+
+  memset(pvStripes, 0, nStripeCount * sizeof(CONCURRENT_STRIPE));
+
+  (*lppList)->pStripes = (LPCONCURRENT_STRIPE) pvStripes;
+
+  for (int i = 0; i < nStripeCount; i++) {
+    LPCONCURRENT_STRIPE lpStripe = &((*lppList)->pStripes[i]);
+
+    CreateListRoot(&(lpStripe->lpRoot));
+    if (lpStripe->lpRoot == NULL) {
+      DestroyConcurrentList(lppList, DeallocateNothing);
+      return;
+    }
+
+    pthread_rwlock_init(&(lpStripe->lock), NULL);
+    (*lppList)->nStripeCount++;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DestroyConcurrentList function
+
+void DestroyConcurrentList(LPPCONCURRENT_LIST lppList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppList == NULL || *lppList == NULL) {
+    return; // Nothing to do
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  for (int i = 0; i < (*lppList)->nStripeCount; i++) {
+    LPCONCURRENT_STRIPE lpStripe = &((*lppList)->pStripes[i]);
+
+    DestroyListRoot(&(lpStripe->lpRoot), lpfnDeallocFunc);
+    pthread_rwlock_destroy(&(lpStripe->lock));
+  }
+
+  free((*lppList)->pStripes);
+  free(*lppList);
+  *lppList = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DoForEachConcurrentElement function
+
+void DoForEachConcurrentElement(LPCONCURRENT_LIST lpList,
+    LPACTION_ROUTINE lpfnAction) {
+  if (lpList == NULL || lpfnAction == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < lpList->nStripeCount; i++) {
+    LPCONCURRENT_STRIPE lpStripe = &(lpList->pStripes[i]);
+
+    pthread_rwlock_rdlock(&(lpStripe->lock));
+    DoForEachRootElement(lpStripe->lpRoot, lpfnAction);
+    pthread_rwlock_unlock(&(lpStripe->lock));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindConcurrentElement function
+
+void* FindConcurrentElement(LPCONCURRENT_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompare) {
+  if (lpList == NULL || lpfnCompare == NULL) {
+    return NULL;  // Required parameters
+  }
+
+  for (int i = 0; i < lpList->nStripeCount; i++) {
+    LPCONCURRENT_STRIPE lpStripe = &(lpList->pStripes[i]);
+    void* pvResult = NULL;
+
+    pthread_rwlock_rdlock(&(lpStripe->lock));
+    LPPOSITION lpFound = FindRootElement(lpStripe->lpRoot, pvSearchKey,
+        lpfnCompare);
+    if (lpFound != NULL) {
+      pvResult = lpFound->pvData;
+    }
+    pthread_rwlock_unlock(&(lpStripe->lock));
+
+    if (lpFound != NULL) {
+      return pvResult;
+    }
+  }
+
+  return NULL;  // If we get here, no element's data meets the criteria
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindConcurrentElementWhere function
+
+void* FindConcurrentElementWhere(LPCONCURRENT_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate) {
+  if (lpList == NULL || lpfnPredicate == NULL) {
+    return NULL;  // Required parameters
+  }
+
+  for (int i = 0; i < lpList->nStripeCount; i++) {
+    LPCONCURRENT_STRIPE lpStripe = &(lpList->pStripes[i]);
+    void* pvResult = NULL;
+
+    pthread_rwlock_rdlock(&(lpStripe->lock));
+    LPPOSITION lpFound = FindRootElementWhere(lpStripe->lpRoot,
+        lpfnPredicate);
+    if (lpFound != NULL) {
+      pvResult = lpFound->pvData;
+    }
+    pthread_rwlock_unlock(&(lpStripe->lock));
+
+    if (lpFound != NULL) {
+      return pvResult;
+    }
+  }
+
+  return NULL;  // If we get here, no element's data meets the criteria
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetConcurrentElementCount function
+
+int GetConcurrentElementCount(LPCONCURRENT_LIST lpList) {
+  int nResult = 0;
+  if (lpList == NULL) {
+    return nResult;
+  }
+
+  for (int i = 0; i < lpList->nStripeCount; i++) {
+    LPCONCURRENT_STRIPE lpStripe = &(lpList->pStripes[i]);
+
+    pthread_rwlock_rdlock(&(lpStripe->lock));
+    nResult += GetRootElementCount(lpStripe->lpRoot);
+    pthread_rwlock_unlock(&(lpStripe->lock));
+  }
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveConcurrentElementWhere function
+
+int RemoveConcurrentElementWhere(LPCONCURRENT_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareFunc, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  int nRemoved = 0;
+
+  if (lpList == NULL || lpfnCompareFunc == NULL || lpfnDeallocFunc == NULL) {
+    return nRemoved; // Required parameters
+  }
+
+  for (int i = 0; i < lpList->nStripeCount; i++) {
+    LPCONCURRENT_STRIPE lpStripe = &(lpList->pStripes[i]);
+
+    pthread_rwlock_wrlock(&(lpStripe->lock));
+    nRemoved += RemoveRootElementWhere(lpStripe->lpRoot, pvSearchKey,
+        lpfnCompareFunc, lpfnDeallocFunc);
+    pthread_rwlock_unlock(&(lpStripe->lock));
+  }
+
+  return nRemoved;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveConcurrentElementWherePredicate function
+
+int RemoveConcurrentElementWherePredicate(LPCONCURRENT_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  int nRemoved = 0;
+
+  if (lpList == NULL || lpfnPredicate == NULL || lpfnDeallocFunc == NULL) {
+    return nRemoved; // Required parameters
+  }
+
+  for (int i = 0; i < lpList->nStripeCount; i++) {
+    LPCONCURRENT_STRIPE lpStripe = &(lpList->pStripes[i]);
+
+    pthread_rwlock_wrlock(&(lpStripe->lock));
+    nRemoved += RemoveRootElementWherePredicate(lpStripe->lpRoot,
+        lpfnPredicate, lpfnDeallocFunc);
+    pthread_rwlock_unlock(&(lpStripe->lock));
+  }
+
+  return nRemoved;
+}
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,229 @@
+// hash_index.c - Implementations of functions that maintain a hash index over
+// the elements of a linked list
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "hash_index.h"
+#include "list_stats_internal.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// InsertHashSlot function - Stores a node in the first free slot of its probe
+// sequence.  The table must have at least one free slot.
+
+static void InsertHashSlot(LPHASH_SLOT pSlots, int nCapacity,
+    LPPOSITION lpPosition, unsigned int nHash) {
+  unsigned int nMask = (unsigned int) nCapacity - 1;
+  unsigned int i = nHash & nMask;
+
+  while (pSlots[i].lpPosition != NULL) {
+    i = (i + 1) & nMask;
+  }
+
+  pSlots[i].lpPosition = lpPosition;
+  pSlots[i].nHash = nHash;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ResizeHashIndex function - Moves all the index's nodes into a new table of
+// the specified capacity, which must be a power of two.
+
+static BOOL ResizeHashIndex(LPHASH_INDEX lpIndex, int nCapacity) {
+  LPHASH_SLOT pSlots = (LPHASH_SLOT) calloc(nCapacity, sizeof(HASH_SLOT));
+  if (pSlots == NULL) {
+    return FALSE;
+  }
+
+  for (int i = 0; i < lpIndex->nCapacity; i++) {
+    if (lpIndex->pSlots[i].lpPosition != NULL) {
+      InsertHashSlot(pSlots, nCapacity, lpIndex->pSlots[i].lpPosition,
+          lpIndex->pSlots[i].nHash);
+    }
+  }
+
+  free(lpIndex->pSlots);
+  lpIndex->pSlots = pSlots;
+  lpIndex->nCapacity = nCapacity;
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AddHashIndexEntry function
+
+BOOL AddHashIndexEntry(LPHASH_INDEX lpIndex, LPPOSITION lpPosition) {
+  if (lpIndex == NULL || lpPosition == NULL) {
+    return FALSE; // Required parameters
+  }
+
+  /* Keep the table at most three-quarters full, so that probe sequences
+   stay short. */
+  if (4 * (lpIndex->nCount + 1) > 3 * lpIndex->nCapacity) {
+    if (!ResizeHashIndex(lpIndex, 2 * lpIndex->nCapacity)) {
+      return FALSE;
+    }
+  }
+
+  InsertHashSlot(lpIndex->pSlots, lpIndex->nCapacity, lpPosition,
+      lpIndex->lpfnHash(lpPosition->pvData));
+  lpIndex->nCount++;
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ClearHashIndex function
+
+void ClearHashIndex(LPHASH_INDEX lpIndex) {
+  if (lpIndex == NULL) {
+    return;
+  }
+
+  memset(lpIndex->pSlots, 0, lpIndex->nCapacity * sizeof(HASH_SLOT));
+  lpIndex->nCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateHashIndex function
+
+void CreateHashIndex(LPPHASH_INDEX lppIndex, LPHASH_ROUTINE lpfnHash,
+    LPCOMPARE_ROUTINE lpfnCompare, int nExpectedCount) {
+  if (lppIndex == NULL) {
+    return; // Required parameter
+  }
+
+  if (lpfnHash == NULL || lpfnCompare == NULL) {
+    *lppIndex = NULL;
+    return; // Required parameters
+  }
+
+  int nCapacity = HASH_INDEX_DEFAULT_CAPACITY;
+  while (4 * (long) nExpectedCount > 3 * (long) nCapacity) {
+    nCapacity *= 2;
+  }
+
+  *lppIndex = (LPHASH_INDEX) malloc(sizeof(HASH_INDEX));
+  if (*lppIndex == NULL) {
+    fprintf(stderr, FAILED_ALLOC_HASH_INDEX);
+    return;
+  }
+
+  (*lppIndex)->pSlots = (LPHASH_SLOT) calloc(nCapacity, sizeof(HASH_SLOT));
+  if ((*lppIndex)->pSlots == NULL) {
+    fprintf(stderr, FAILED_ALLOC_HASH_INDEX);
+    free(*lppIndex);
+    *lppIndex = NULL;
+    return;
+  }
+
+  (*lppIndex)->nCapacity = nCapacity;
+  (*lppIndex)->nCount = 0;
+  (*lppIndex)->lpfnHash = lpfnHash;
+  (*lppIndex)->lpfnCompare = lpfnCompare;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DestroyHashIndex function
+
+void DestroyHashIndex(LPPHASH_INDEX lppIndex) {
+  if (lppIndex == NULL || *lppIndex == NULL) {
+    return; // Nothing to do
+  }
+
+  free((*lppIndex)->pSlots);
+  free(*lppIndex);
+  *lppIndex = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindHashIndexEntry function
+
+LPPOSITION FindHashIndexEntry(LPHASH_INDEX lpIndex, void* pvSearchKey) {
+  if (lpIndex == NULL) {
+    return NULL; // Required parameter
+  }
+
+  unsigned int nHash = lpIndex->lpfnHash(pvSearchKey);
+  unsigned int nMask = (unsigned int) lpIndex->nCapacity - 1;
+
+  for (unsigned int i = nHash & nMask; lpIndex->pSlots[i].lpPosition != NULL;
+      i = (i + 1) & nMask) {
+    LPHASH_SLOT lpSlot = &(lpIndex->pSlots[i]);
+    if (lpSlot->nHash != nHash) {
+      continue;
+    }
+
+    LIST_STATS_COUNT(nComparisons, 1);
+    if (lpIndex->lpfnCompare(pvSearchKey, lpSlot->lpPosition->pvData)) {
+      return lpSlot->lpPosition;
+    }
+  }
+
+  return NULL;  // If we get here, no element's data matches the key
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveHashIndexEntry function
+
+void RemoveHashIndexEntry(LPHASH_INDEX lpIndex, LPPOSITION lpPosition) {
+  if (lpIndex == NULL || lpPosition == NULL) {
+    return; // Required parameters
+  }
+
+  unsigned int nMask = (unsigned int) lpIndex->nCapacity - 1;
+  unsigned int i = lpIndex->lpfnHash(lpPosition->pvData) & nMask;
+
+  while (lpIndex->pSlots[i].lpPosition != lpPosition) {
+    if (lpIndex->pSlots[i].lpPosition == NULL) {
+      return; // Node is not in the index
+    }
+    i = (i + 1) & nMask;
+  }
+
+  /* Rather than leaving a tombstone behind, shift back each of the nodes
+   further along the probe sequence that would otherwise become unreachable,
+   so that lookups never have to skip over deleted slots. */
+  unsigned int j = i;
+  while (TRUE) {
+    j = (j + 1) & nMask;
+    if (lpIndex->pSlots[j].lpPosition == NULL) {
+      break;
+    }
+
+    unsigned int nHome = lpIndex->pSlots[j].nHash & nMask;
+    BOOL bMovable = (i <= j) ? (nHome <= i || nHome > j)
+        : (nHome <= i && nHome > j);
+    if (bMovable) {
+      lpIndex->pSlots[i] = lpIndex->pSlots[j];
+      i = j;
+    }
+  }
+
+  lpIndex->pSlots[i].lpPosition = NULL;
+  lpIndex->pSlots[i].nHash = 0;
+  lpIndex->nCount--;
+}
+
+//////////////////////////////////////////////////////////////////////////////
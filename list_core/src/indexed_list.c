@@ -0,0 +1,362 @@
+// indexed_list.c - Provides the implementation of the INDEXED_LIST data
+// structure, a gap buffer of data pointers addressed by index
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "indexed_list.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// GetIndexedSlot function - Translates the index of an element into the
+// index of the slot that holds its data, by skipping over the gap.
+
+static int GetIndexedSlot(LPINDEXED_LIST lpList, int nIndex) {
+  if (nIndex < lpList->nGapStart) {
+    return nIndex;
+  }
+
+  return nIndex + (lpList->nGapEnd - lpList->nGapStart);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GrowIndexedList function - Moves the elements into a larger array,
+// keeping the gap where it is.
+
+static BOOL GrowIndexedList(LPINDEXED_LIST lpList) {
+  int nCapacity = lpList->nCapacity > 0
+      ? 2 * lpList->nCapacity : INDEXED_LIST_DEFAULT_CAPACITY;
+  int nTailLength = lpList->nCapacity - lpList->nGapEnd;
+
+  void** ppvData = (void**) malloc(nCapacity * sizeof(void*));
+  if (ppvData == NULL) {
+    return FALSE;
+  }
+
+  memcpy(ppvData, lpList->ppvData, lpList->nGapStart * sizeof(void*));
+  memcpy(ppvData + nCapacity - nTailLength,
+      lpList->ppvData + lpList->nGapEnd, nTailLength * sizeof(void*));
+
+  free(lpList->ppvData);
+
+  lpList->ppvData = ppvData;
+  lpList->nCapacity = nCapacity;
+  lpList->nGapEnd = nCapacity - nTailLength;
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// MoveIndexedGap function - Moves the gap so that it starts at the specified
+// index, by shifting the elements that lie between its old and new places.
+
+static void MoveIndexedGap(LPINDEXED_LIST lpList, int nIndex) {
+  int nGapLength = lpList->nGapEnd - lpList->nGapStart;
+
+  if (nIndex < lpList->nGapStart) {
+    memmove(lpList->ppvData + nIndex + nGapLength, lpList->ppvData + nIndex,
+        (lpList->nGapStart - nIndex) * sizeof(void*));
+  } else if (nIndex > lpList->nGapStart) {
+    memmove(lpList->ppvData + lpList->nGapStart,
+        lpList->ppvData + lpList->nGapEnd,
+        (nIndex - lpList->nGapStart) * sizeof(void*));
+  }
+
+  lpList->nGapStart = nIndex;
+  lpList->nGapEnd = nIndex + nGapLength;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AddIndexedElement function
+
+BOOL AddIndexedElement(LPINDEXED_LIST lpList, void* pvData) {
+  if (lpList == NULL) {
+    return FALSE; // Required parameter
+  }
+
+  return InsertIndexedElement(lpList, GetIndexedElementCount(lpList), pvData);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ClearIndexedList function
+
+void ClearIndexedList(LPINDEXED_LIST lpList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpList == NULL) {
+    return; // Required parameter
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  DoForEachIndexedElement(lpList, lpfnDeallocFunc);
+
+  lpList->nGapStart = 0;
+  lpList->nGapEnd = lpList->nCapacity;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateIndexedList function
+
+void CreateIndexedList(LPPINDEXED_LIST lppList, int nInitialCapacity) {
+  if (lppList == NULL) {
+    return; // Required parameter
+  }
+
+  *lppList = (LPINDEXED_LIST) malloc(sizeof(INDEXED_LIST));
+  if (*lppList == NULL) {
+    fprintf(stderr, FAILED_ALLOC_LIST);
+    return;
+  }
+
+  if (nInitialCapacity <= 0) {
+    nInitialCapacity = INDEXED_LIST_DEFAULT_CAPACITY;
+  }
+
+  (*lppList)->ppvData = (void**) malloc(nInitialCapacity * sizeof(void*));
+  if ((*lppList)->ppvData == NULL) {
+    fprintf(stderr, FAILED_ALLOC_LIST_STORAGE);
+    free(*lppList);
+    *lppList = NULL;
+    return;
+  }
+
+  (*lppList)->nCapacity = nInitialCapacity;
+  (*lppList)->nGapStart = 0;
+  (*lppList)->nGapEnd = nInitialCapacity;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateIndexedListFromPositions function
+
+void CreateIndexedListFromPositions(LPPINDEXED_LIST lppList,
+    LPPOSITION lpElement) {
+  if (lppList == NULL) {
+    return; // Required parameter
+  }
+
+  CreateIndexedList(lppList, GetElementCount(lpElement));
+  if (*lppList == NULL) {
+    return;
+  }
+
+  MoveToHeadPosition(&lpElement);
+
+  /* The array was sized to fit, so the elements are simply copied into the
+   front of it, and the gap is left at the tail. */
+  int nCount = 0;
+  for (; lpElement != NULL; lpElement = lpElement->pNext) {
+    (*lppList)->ppvData[nCount++] = lpElement->pvData;
+  }
+
+  (*lppList)->nGapStart = nCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateListFromIndexedList function
+
+int CreateListFromIndexedList(LPPPOSITION lppNewHead, LPINDEXED_LIST lpList) {
+  if (lppNewHead == NULL) {
+    return 0; // Required parameter
+  }
+
+  *lppNewHead = NULL;
+
+  if (lpList == NULL) {
+    return 0; // Required parameter
+  }
+
+  /* With the gap out of the way at the tail, the elements occupy the front
+   of the array, in order. */
+  int nCount = GetIndexedElementCount(lpList);
+  MoveIndexedGap(lpList, nCount);
+
+  return CreateListFromArray(lppNewHead, lpList->ppvData, nCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DestroyIndexedList function
+
+void DestroyIndexedList(LPPINDEXED_LIST lppList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppList == NULL || *lppList == NULL) {
+    return; // Nothing to do
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  ClearIndexedList(*lppList, lpfnDeallocFunc);
+
+  free((*lppList)->ppvData);
+  free(*lppList);
+  *lppList = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DoForEachIndexedElement function
+
+void DoForEachIndexedElement(LPINDEXED_LIST lpList,
+    LPACTION_ROUTINE lpfnAction) {
+  if (lpList == NULL || lpfnAction == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < lpList->nGapStart; i++) {
+    lpfnAction(lpList->ppvData[i]);
+  }
+
+  for (int i = lpList->nGapEnd; i < lpList->nCapacity; i++) {
+    lpfnAction(lpList->ppvData[i]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetIndexedElement function
+
+void* GetIndexedElement(LPINDEXED_LIST lpList, int nIndex) {
+  if (lpList == NULL) {
+    return NULL; // Required parameter
+  }
+
+  if (nIndex < 0 || nIndex >= GetIndexedElementCount(lpList)) {
+    return NULL; // Out of range
+  }
+
+  return lpList->ppvData[GetIndexedSlot(lpList, nIndex)];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetIndexedElementCount function
+
+int GetIndexedElementCount(LPINDEXED_LIST lpList) {
+  if (lpList == NULL) {
+    return 0;
+  }
+
+  return lpList->nCapacity - (lpList->nGapEnd - lpList->nGapStart);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetIndexedElements function
+
+int GetIndexedElements(LPINDEXED_LIST lpList, int nStart, int nCount,
+    void** ppvData) {
+  if (lpList == NULL || ppvData == NULL || nStart < 0 || nCount < 0) {
+    return ERROR; // Required parameters
+  }
+
+  int nElementCount = GetIndexedElementCount(lpList);
+  if (nStart >= nElementCount) {
+    return 0; // Nothing to copy
+  }
+
+  if (nCount > nElementCount - nStart) {
+    nCount = nElementCount - nStart;
+  }
+
+  /* The run is copied in up to two pieces: the part before the gap, and the
+   part after it. */
+  int nCopied = 0;
+  if (nStart < lpList->nGapStart) {
+    nCopied = lpList->nGapStart - nStart;
+    if (nCopied > nCount) {
+      nCopied = nCount;
+    }
+    memcpy(ppvData, lpList->ppvData + nStart, nCopied * sizeof(void*));
+  }
+
+  if (nCopied < nCount) {
+    memcpy(ppvData + nCopied,
+        lpList->ppvData + GetIndexedSlot(lpList, nStart + nCopied),
+        (nCount - nCopied) * sizeof(void*));
+  }
+
+  return nCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// InsertIndexedElement function
+
+BOOL InsertIndexedElement(LPINDEXED_LIST lpList, int nIndex, void* pvData) {
+  if (lpList == NULL) {
+    return FALSE; // Required parameter
+  }
+
+  if (nIndex < 0 || nIndex > GetIndexedElementCount(lpList)) {
+    return FALSE; // Out of range
+  }
+
+  if (lpList->nGapStart == lpList->nGapEnd && !GrowIndexedList(lpList)) {
+    fprintf(stderr, FAILED_ALLOC_LIST_STORAGE);
+    return FALSE;
+  }
+
+  MoveIndexedGap(lpList, nIndex);
+
+  lpList->ppvData[lpList->nGapStart++] = pvData;
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveIndexedElement function
+
+BOOL RemoveIndexedElement(LPINDEXED_LIST lpList, int nIndex,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpList == NULL || lpfnDeallocFunc == NULL) {
+    return FALSE; // Required parameters
+  }
+
+  if (nIndex < 0 || nIndex >= GetIndexedElementCount(lpList)) {
+    return FALSE; // Out of range
+  }
+
+  MoveIndexedGap(lpList, nIndex);
+
+  lpfnDeallocFunc(lpList->ppvData[lpList->nGapEnd++]);
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SetIndexedElement function
+
+void* SetIndexedElement(LPINDEXED_LIST lpList, int nIndex, void* pvData) {
+  if (lpList == NULL) {
+    return NULL; // Required parameter
+  }
+
+  if (nIndex < 0 || nIndex >= GetIndexedElementCount(lpList)) {
+    return NULL; // Out of range
+  }
+
+  int nSlot = GetIndexedSlot(lpList, nIndex);
+  void* pvOldData = lpList->ppvData[nSlot];
+  lpList->ppvData[nSlot] = pvData;
+
+  return pvOldData;
+}
@@ -0,0 +1,305 @@
+// intrusive_list.c - Provides the implementation of the INTRUSIVE_LIST data
+// structure
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "intrusive_list.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// GetIntrusiveLink function - Gets the address of the link embedded in a
+// record.
+
+static LPINTRUSIVE_LINK GetIntrusiveLink(LPINTRUSIVE_LIST lpList,
+    void* pvRecord) {
+  return (LPINTRUSIVE_LINK) ((char*) pvRecord + lpList->nLinkOffset);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetIntrusiveRecord function - Gets the address of the record in which a
+// link is embedded.
+
+static void* GetIntrusiveRecord(LPINTRUSIVE_LIST lpList,
+    LPINTRUSIVE_LINK lpLink) {
+  if (lpLink == NULL) {
+    return NULL;
+  }
+
+  return (char*) lpLink - lpList->nLinkOffset;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// UnlinkIntrusiveLink function - Detaches a link from the list and updates
+// the list's bookkeeping.
+
+static void UnlinkIntrusiveLink(LPINTRUSIVE_LIST lpList,
+    LPINTRUSIVE_LINK lpLink) {
+  if (lpLink->pPrev != NULL) {
+    lpLink->pPrev->pNext = lpLink->pNext;
+  } else {
+    lpList->pHead = lpLink->pNext;
+  }
+
+  if (lpLink->pNext != NULL) {
+    lpLink->pNext->pPrev = lpLink->pPrev;
+  } else {
+    lpList->pTail = lpLink->pPrev;
+  }
+
+  lpLink->pPrev = NULL;
+  lpLink->pNext = NULL;
+
+  lpList->nCount--;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AddIntrusiveElement function
+
+void AddIntrusiveElement(LPINTRUSIVE_LIST lpList, void* pvRecord) {
+  if (lpList == NULL) {
+    return; // Required parameter
+  }
+
+  AddIntrusiveElementAfter(lpList, GetIntrusiveRecord(lpList, lpList->pTail),
+      pvRecord);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AddIntrusiveElementAfter function
+
+void AddIntrusiveElementAfter(LPINTRUSIVE_LIST lpList, void* pvAfter,
+    void* pvRecord) {
+  if (lpList == NULL || pvRecord == NULL) {
+    return; // Required parameters
+  }
+
+  LPINTRUSIVE_LINK lpLink = GetIntrusiveLink(lpList, pvRecord);
+
+  if (pvAfter == NULL) {
+    lpLink->pPrev = NULL;
+    lpLink->pNext = lpList->pHead;
+    if (lpList->pHead != NULL) {
+      lpList->pHead->pPrev = lpLink;
+    }
+    lpList->pHead = lpLink;
+  } else {
+    LPINTRUSIVE_LINK lpAfter = GetIntrusiveLink(lpList, pvAfter);
+    lpLink->pPrev = lpAfter;
+    lpLink->pNext = lpAfter->pNext;
+    if (lpAfter->pNext != NULL) {
+      lpAfter->pNext->pPrev = lpLink;
+    }
+    lpAfter->pNext = lpLink;
+  }
+
+  if (lpLink->pNext == NULL) {
+    lpList->pTail = lpLink;
+  }
+
+  lpList->nCount++;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ClearIntrusiveList function
+
+void ClearIntrusiveList(LPINTRUSIVE_LIST lpList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpList == NULL) {
+    return; // Required parameter
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  LPINTRUSIVE_LINK lpLink = lpList->pHead;
+  while (lpLink != NULL) {
+    LPINTRUSIVE_LINK lpNext = lpLink->pNext;
+    lpLink->pPrev = NULL;
+    lpLink->pNext = NULL;
+    lpfnDeallocFunc(GetIntrusiveRecord(lpList, lpLink));
+    lpLink = lpNext;
+  }
+
+  lpList->pHead = NULL;
+  lpList->pTail = NULL;
+  lpList->nCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DoForEachIntrusiveElement function
+
+void DoForEachIntrusiveElement(LPINTRUSIVE_LIST lpList,
+    LPACTION_ROUTINE lpfnAction) {
+  if (lpList == NULL || lpfnAction == NULL) {
+    return;
+  }
+
+  LPINTRUSIVE_LINK lpLink = lpList->pHead;
+  while (lpLink != NULL) {
+    LPINTRUSIVE_LINK lpNext = lpLink->pNext;
+    lpfnAction(GetIntrusiveRecord(lpList, lpLink));
+    lpLink = lpNext;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindIntrusiveElement function
+
+void* FindIntrusiveElement(LPINTRUSIVE_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompare) {
+  if (lpList == NULL || lpfnCompare == NULL) {
+    return NULL;  // Required parameters
+  }
+
+  for (LPINTRUSIVE_LINK lpLink = lpList->pHead; lpLink != NULL;
+      lpLink = lpLink->pNext) {
+    void* pvRecord = GetIntrusiveRecord(lpList, lpLink);
+    if (lpfnCompare(pvSearchKey, pvRecord)) {
+      return pvRecord;
+    }
+  }
+
+  return NULL;  // If we get here, no record matches the key
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindIntrusiveElementWhere function
+
+void* FindIntrusiveElementWhere(LPINTRUSIVE_LIST lpList,
+    LPPREDICATE_ROUTINE lpfnPredicate) {
+  if (lpList == NULL || lpfnPredicate == NULL) {
+    return NULL;  // Required parameters
+  }
+
+  for (LPINTRUSIVE_LINK lpLink = lpList->pHead; lpLink != NULL;
+      lpLink = lpLink->pNext) {
+    void* pvRecord = GetIntrusiveRecord(lpList, lpLink);
+    if (lpfnPredicate(pvRecord)) {
+      return pvRecord;
+    }
+  }
+
+  return NULL;  // If we get here, no record meets the criteria
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetIntrusiveElementCount function
+
+int GetIntrusiveElementCount(LPINTRUSIVE_LIST lpList) {
+  if (lpList == NULL) {
+    return 0;
+  }
+
+  return lpList->nCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetIntrusiveHead function
+
+void* GetIntrusiveHead(LPINTRUSIVE_LIST lpList) {
+  if (lpList == NULL) {
+    return NULL;
+  }
+
+  return GetIntrusiveRecord(lpList, lpList->pHead);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetNextIntrusiveElement function
+
+void* GetNextIntrusiveElement(LPINTRUSIVE_LIST lpList, void* pvRecord) {
+  if (lpList == NULL || pvRecord == NULL) {
+    return NULL; // Required parameters
+  }
+
+  return GetIntrusiveRecord(lpList,
+      GetIntrusiveLink(lpList, pvRecord)->pNext);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// InitializeIntrusiveList function
+
+void InitializeIntrusiveList(LPINTRUSIVE_LIST lpList, size_t nLinkOffset) {
+  if (lpList == NULL) {
+    return; // Required parameter
+  }
+
+  lpList->pHead = NULL;
+  lpList->pTail = NULL;
+  lpList->nCount = 0;
+  lpList->nLinkOffset = nLinkOffset;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveIntrusiveElement function
+
+void* RemoveIntrusiveElement(LPINTRUSIVE_LIST lpList, void* pvRecord,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpList == NULL || pvRecord == NULL) {
+    return NULL; // Required parameters
+  }
+
+  LPINTRUSIVE_LINK lpLink = GetIntrusiveLink(lpList, pvRecord);
+  void* pvNext = GetIntrusiveRecord(lpList, lpLink->pNext);
+
+  UnlinkIntrusiveLink(lpList, lpLink);
+
+  if (lpfnDeallocFunc != NULL) {
+    lpfnDeallocFunc(pvRecord);
+  }
+
+  return pvNext;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveIntrusiveElementWhere function
+
+int RemoveIntrusiveElementWhere(LPINTRUSIVE_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareFunc, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  int nRemoved = 0;
+
+  if (lpList == NULL || lpfnCompareFunc == NULL) {
+    return nRemoved; // Required parameters
+  }
+
+  LPINTRUSIVE_LINK lpLink = lpList->pHead;
+  while (lpLink != NULL) {
+    LPINTRUSIVE_LINK lpNext = lpLink->pNext;
+
+    void* pvRecord = GetIntrusiveRecord(lpList, lpLink);
+    if (lpfnCompareFunc(pvSearchKey, pvRecord)) {
+      UnlinkIntrusiveLink(lpList, lpLink);
+      if (lpfnDeallocFunc != NULL) {
+        lpfnDeallocFunc(pvRecord);
+      }
+      nRemoved++;
+    }
+
+    lpLink = lpNext;
+  }
+
+  return nRemoved;
+}
@@ -21,6 +21,286 @@
 #include "list_core.h"
 
 #include "position.h"
+#include "position_pool.h"
+#include "list_teardown.h"
+#include "list_traversal.h"
+#include "list_stats_internal.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal types
+
+/**
+ * @brief Criteria by which RemovePositionsWhere selects the nodes to remove.
+ * Exactly one of the four routines is set.
+ */
+typedef struct _tagMATCH_CRITERIA {
+  void* pvSearchKey;
+  LPCOMPARE_ROUTINE lpfnCompare;
+  LPPREDICATE_ROUTINE lpfnPredicate;
+  LPCOMPARE_ROUTINE_EX lpfnCompareEx;
+  LPPREDICATE_ROUTINE_EX lpfnPredicateEx;
+  void* pvContext;
+} MATCH_CRITERIA, *LPMATCH_CRITERIA;
+
+/**
+ * @brief Chain of nodes that is waiting to be deallocated by a background
+ * thread; see StartAsyncClear.
+ */
+typedef struct _tagASYNC_CLEAR {
+  LPPOSITION lpFirst;
+  LPDEALLOC_ROUTINE lpfnDeallocFunc;
+  LPPOSITION_POOL lpPool;
+} ASYNC_CLEAR, *LPASYNC_CLEAR;
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal variables
+
+/**
+ * @brief Number of background threads that are still deallocating chains,
+ * along with the means of waiting for it to drop to zero.
+ */
+static int g_nPendingAsyncClears = 0;
+static pthread_mutex_t g_asyncClearMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_asyncClearDone = PTHREAD_COND_INITIALIZER;
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AppendNewPositions function - Allocates one node per array item and links
+// the new nodes after lpTail (which may be NULL) in a single pass.  Returns
+// the number of nodes created, along with the first and last of them.
+
+static int AppendNewPositions(LPPOSITION lpTail, void** ppvData, int nCount,
+    LPPPOSITION lppFirst, LPPPOSITION lppLast) {
+  int nAdded = 0;
+
+  *lppFirst = NULL;
+  *lppLast = lpTail;
+
+  for (; nAdded < nCount; nAdded++) {
+    LPPOSITION lpNew = NULL;
+
+    CreatePosition(&lpNew);
+    if (lpNew == NULL) {
+      fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+      break;
+    }
+
+    lpNew->pvData = ppvData[nAdded];
+    lpNew->pPrev = lpTail;
+    if (lpTail != NULL) {
+      lpTail->pNext = lpNew;
+    }
+    lpTail = lpNew;
+
+    if (*lppFirst == NULL) {
+      *lppFirst = lpNew;
+    }
+  }
+
+  *lppLast = lpTail;
+
+  return nAdded;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AsyncClearThreadProc function - Body of the background thread started by
+// StartAsyncClear.
+
+static void* AsyncClearThreadProc(void* pvClear) {
+  LPASYNC_CLEAR lpClear = (LPASYNC_CLEAR) pvClear;
+
+  DestroyPositions(lpClear->lpFirst, lpClear->lpfnDeallocFunc,
+      lpClear->lpPool);
+  free(lpClear);
+
+  pthread_mutex_lock(&g_asyncClearMutex);
+  if (--g_nPendingAsyncClears == 0) {
+    pthread_cond_broadcast(&g_asyncClearDone);
+  }
+  pthread_mutex_unlock(&g_asyncClearMutex);
+
+  return NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DestroyPositions function - Deallocates a detached chain of nodes, along
+// with their data, in a single pass.  See list_teardown.h.
+
+int DestroyPositions(LPPOSITION lpFirst, LPDEALLOC_ROUTINE lpfnDeallocFunc,
+    LPPOSITION_POOL lpPool) {
+  int nCount = 0;
+  LPPOSITION lpElement = lpFirst;
+
+  while (lpElement != NULL) {
+    // The link is read before the node goes away, which rules out the
+    // traversal cursor; prefetch the next node's data by hand instead
+    LPPOSITION lpNext = lpElement->pNext;
+#if LIST_CORE_PREFETCH_DISTANCE > 0
+    if (lpNext != NULL) {
+      __builtin_prefetch(lpNext->pvData);
+      __builtin_prefetch(lpNext->pNext);
+    }
+#endif //LIST_CORE_PREFETCH_DISTANCE
+
+    lpfnDeallocFunc(lpElement->pvData);
+    if (lpPool == NULL) {
+      free(lpElement);
+    }
+
+    lpElement = lpNext;
+    nCount++;
+  }
+
+  if (lpPool != NULL) {
+    DestroyPositionPool(&lpPool);
+  } else {
+    LIST_STATS_COUNT(nFrees, nCount);
+  }
+
+  return nCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// IsMatchingPosition function - Determines whether a node's data meets the
+// specified criteria.
+
+static BOOL IsMatchingPosition(LPMATCH_CRITERIA lpCriteria,
+    LPPOSITION lpElement) {
+  LIST_STATS_COUNT(nComparisons, 1);
+
+  if (lpCriteria->lpfnCompare != NULL) {
+    return lpCriteria->lpfnCompare(lpCriteria->pvSearchKey,
+        lpElement->pvData);
+  }
+
+  if (lpCriteria->lpfnPredicate != NULL) {
+    return lpCriteria->lpfnPredicate(lpElement->pvData);
+  }
+
+  if (lpCriteria->lpfnCompareEx != NULL) {
+    return lpCriteria->lpfnCompareEx(lpCriteria->pvSearchKey,
+        lpElement->pvData, lpCriteria->pvContext);
+  }
+
+  return lpCriteria->lpfnPredicateEx(lpElement->pvData,
+      lpCriteria->pvContext);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// MergeSortedRuns function - Merges two sorted, NULL-terminated runs of nodes
+// into one, following the pNext links only.  On ties, nodes of the first run
+// come first, which is what makes the sort stable.
+
+static LPPOSITION MergeSortedRuns(LPPOSITION lpFirst, LPPOSITION lpSecond,
+    LPSORT_COMPARE_ROUTINE lpfnCompare) {
+  POSITION head;
+  LPPOSITION lpTail = &head;
+
+  while (lpFirst != NULL && lpSecond != NULL) {
+    LIST_STATS_COUNT(nComparisons, 1);
+    if (lpfnCompare(lpSecond->pvData, lpFirst->pvData) < 0) {
+      lpTail->pNext = lpSecond;
+      lpSecond = lpSecond->pNext;
+    } else {
+      lpTail->pNext = lpFirst;
+      lpFirst = lpFirst->pNext;
+    }
+    lpTail = lpTail->pNext;
+  }
+
+  lpTail->pNext = lpFirst != NULL ? lpFirst : lpSecond;
+
+  return head.pNext;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemovePositionsWhere function - Walks the list once from the head, and
+// unlinks and deallocates each node that meets the specified criteria.  The
+// current element pointer is left alone if its element survives.
+
+static int RemovePositionsWhere(LPPPOSITION lppElement,
+    LPMATCH_CRITERIA lpCriteria, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  int nRemoved = 0;
+  BOOL bCurrentRemoved = FALSE;
+  LPPOSITION lpNewHead = NULL;
+  LPPOSITION lpElement = *lppElement;
+
+  MoveToHeadPosition(&lpElement);
+
+  while (lpElement != NULL) {
+    LPPOSITION lpNext = lpElement->pNext;
+
+    if (!IsMatchingPosition(lpCriteria, lpElement)) {
+      if (lpNewHead == NULL) {
+        lpNewHead = lpElement;
+      }
+      lpElement = lpNext;
+      continue;
+    }
+
+    if (lpElement->pPrev != NULL) {
+      lpElement->pPrev->pNext = lpNext;
+    }
+    if (lpNext != NULL) {
+      lpNext->pPrev = lpElement->pPrev;
+    }
+
+    if (lpElement == *lppElement) {
+      bCurrentRemoved = TRUE;
+    }
+
+    lpfnDeallocFunc(lpElement->pvData);
+    DestroyPosition(&lpElement);
+    nRemoved++;
+
+    lpElement = lpNext;
+  }
+
+  if (bCurrentRemoved) {
+    *lppElement = lpNewHead;
+  }
+
+  return nRemoved;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// StartAsyncClear function - Hands a detached chain of nodes to a background
+// thread for deallocation.  See list_teardown.h.
+
+void StartAsyncClear(LPPOSITION lpFirst, LPDEALLOC_ROUTINE lpfnDeallocFunc,
+    LPPOSITION_POOL lpPool) {
+  LPASYNC_CLEAR lpClear = (LPASYNC_CLEAR) malloc(sizeof(ASYNC_CLEAR));
+  if (lpClear == NULL) {
+    DestroyPositions(lpFirst, lpfnDeallocFunc, lpPool);
+    return;
+  }
+
+  lpClear->lpFirst = lpFirst;
+  lpClear->lpfnDeallocFunc = lpfnDeallocFunc;
+  lpClear->lpPool = lpPool;
+
+  pthread_mutex_lock(&g_asyncClearMutex);
+  g_nPendingAsyncClears++;
+  pthread_mutex_unlock(&g_asyncClearMutex);
+
+  pthread_attr_t attr;
+  pthread_t thread;
+  BOOL bStarted = FALSE;
+
+  if (pthread_attr_init(&attr) == 0) {
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    bStarted = pthread_create(&thread, &attr, AsyncClearThreadProc,
+        lpClear) == 0;
+    pthread_attr_destroy(&attr);
+  }
+
+  if (!bStarted) {
+    // Do the work here instead; the thread procedure does the bookkeeping
+    AsyncClearThreadProc(lpClear);
+  }
+}
 
 //////////////////////////////////////////////////////////////////////////////
 // Publicly-exposed functions
@@ -46,6 +326,79 @@ void AddElement(LPPPOSITION lppElement, void* pvData) {
   *lppElement = lpNew;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// AddElementSorted function
+
+void AddElementSorted(LPPPOSITION lppElement, void* pvData,
+    LPSORT_COMPARE_ROUTINE lpfnCompare) {
+  if (lppElement == NULL || lpfnCompare == NULL) {
+    return; // Required parameters
+  }
+
+  if (*lppElement == NULL) {
+    CreateList(lppElement, pvData);
+    return;
+  }
+
+  /* Find the last element that does not sort after the new data; the new
+   element goes right after it, or at the head if there is no such element. */
+  LPPOSITION lpAfter = NULL;
+  LPPOSITION lpElement = *lppElement;
+
+  MoveToHeadPosition(&lpElement);
+  while (lpElement != NULL) {
+    LIST_STATS_COUNT(nNodesTraversed, 1);
+    LIST_STATS_COUNT(nComparisons, 1);
+    if (lpfnCompare(lpElement->pvData, pvData) > 0) {
+      break;
+    }
+    lpAfter = lpElement;
+    lpElement = lpElement->pNext;
+  }
+
+  LPPOSITION lpNew = NULL;
+
+  CreatePosition(&lpNew);
+  if (lpNew == NULL) {
+    fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+    return;
+  }
+
+  SetPositionData(lpNew, pvData);
+
+  lpNew->pPrev = lpAfter;
+  lpNew->pNext = lpElement;
+  if (lpAfter != NULL) {
+    lpAfter->pNext = lpNew;
+  }
+  if (lpElement != NULL) {
+    lpElement->pPrev = lpNew;
+  }
+
+  *lppElement = lpNew;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AddElementsFromArray function
+
+int AddElementsFromArray(LPPPOSITION lppElement, void** ppvData, int nCount) {
+  if (lppElement == NULL || ppvData == NULL || nCount <= 0) {
+    return 0; // Required parameters
+  }
+
+  LPPOSITION lpFirst = NULL;
+  LPPOSITION lpLast = NULL;
+
+  MoveToTailPosition(lppElement);
+
+  int nAdded = AppendNewPositions(*lppElement, ppvData, nCount,
+      &lpFirst, &lpLast);
+
+  *lppElement = lpLast;
+
+  return nAdded;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // AddElementToTail function
 
@@ -68,11 +421,61 @@ void ClearList(LPPPOSITION lppElement,
     return; // Required parameter
   }
 
-  MoveToTailPosition(lppElement);
+  MoveToHeadPosition(lppElement);
+
+  LPPOSITION lpHead = *lppElement;
+  *lppElement = NULL;
 
-  while (*lppElement != NULL) {
-    RemoveElement(lppElement, lpfnDeallocFunc);
+  DestroyPositions(lpHead, lpfnDeallocFunc, NULL);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ClearListAsync function
+
+void ClearListAsync(LPPPOSITION lppElement,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppElement == NULL || *lppElement == NULL) {
+    return; // Required parameter
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
   }
+
+  MoveToHeadPosition(lppElement);
+
+  LPPOSITION lpHead = *lppElement;
+  *lppElement = NULL;
+
+  StartAsyncClear(lpHead, lpfnDeallocFunc, NULL);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ConcatenateLists function
+
+void ConcatenateLists(LPPPOSITION lppFirst, LPPPOSITION lppSecond) {
+  if (lppFirst == NULL || lppSecond == NULL) {
+    return; // Required parameters
+  }
+
+  if (*lppSecond == NULL) {
+    return; // Nothing to do
+  }
+
+  LPPOSITION lpHead = *lppSecond;
+  MoveToHeadPosition(&lpHead);
+  *lppSecond = NULL;
+
+  if (*lppFirst == NULL) {
+    *lppFirst = lpHead;
+    return;
+  }
+
+  LPPOSITION lpTail = *lppFirst;
+  MoveToTailPosition(&lpTail);
+
+  lpTail->pNext = lpHead;
+  lpHead->pPrev = lpTail;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -88,6 +491,25 @@ void CreateList(LPPPOSITION lppNewHead, void* pvData) {
   SetPositionData(*lppNewHead, pvData);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// CreateListFromArray function
+
+int CreateListFromArray(LPPPOSITION lppNewHead, void** ppvData, int nCount) {
+  if (lppNewHead == NULL) {
+    return 0;
+  }
+
+  *lppNewHead = NULL;
+
+  if (ppvData == NULL || nCount <= 0) {
+    return 0; // Required parameters
+  }
+
+  LPPOSITION lpLast = NULL;
+
+  return AppendNewPositions(NULL, ppvData, nCount, lppNewHead, &lpLast);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // DeallocateNothing function
 
@@ -115,9 +537,67 @@ void DoForEach(LPPOSITION lpElement, LPACTION_ROUTINE lpfnAction) {
 
   MoveToHeadPosition(&lpElement);
 
-  do {
+  TRAVERSAL_CURSOR cursor;
+  BeginTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
     lpfnAction(lpElement->pvData);
-  } while ((lpElement = lpElement->pNext) != NULL);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DoForEachEx function
+
+void DoForEachEx(LPPOSITION lpElement, LPACTION_ROUTINE_EX lpfnAction,
+    void* pvContext) {
+  if (lpElement == NULL || lpfnAction == NULL) {
+    return;
+  }
+
+  MoveToHeadPosition(&lpElement);
+
+  TRAVERSAL_CURSOR cursor;
+  BeginTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    lpfnAction(lpElement->pvData, pvContext);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DoForEachInRange function
+
+LPPOSITION DoForEachInRange(LPPOSITION lpStart, LPPOSITION lpEnd,
+    LPITERATION_ROUTINE lpfnIteration, void* pvContext) {
+  if (lpStart == NULL || lpfnIteration == NULL) {
+    return NULL; // Required parameters
+  }
+
+  LPPOSITION lpElement = NULL;
+  TRAVERSAL_CURSOR cursor;
+  BeginTraversal(&cursor, lpStart, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    if (lpfnIteration(lpElement->pvData, pvContext) == ITERATION_STOP) {
+      return lpElement;
+    }
+    if (lpElement == lpEnd) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DoForEachUntil function
+
+LPPOSITION DoForEachUntil(LPPOSITION lpElement,
+    LPITERATION_ROUTINE lpfnIteration, void* pvContext) {
+  if (lpElement == NULL || lpfnIteration == NULL) {
+    return NULL; // Required parameters
+  }
+
+  MoveToHeadPosition(&lpElement);
+
+  return DoForEachInRange(lpElement, NULL, lpfnIteration, pvContext);
 }
 //////////////////////////////////////////////////////////////////////////////
 // FindElement function
@@ -129,17 +609,42 @@ LPPOSITION FindElement(LPPOSITION lpElement,
   }
 
   MoveToHeadPosition(&lpElement);
-  do {
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    LIST_STATS_COUNT(nComparisons, 1);
     void *pvCurrentEltData = lpElement->pvData;
     if (lpfnCompare(pvSearchKey, pvCurrentEltData)) {
       return lpElement;
     }
-  } while ((lpElement = lpElement->pNext) != NULL);
+  }
 
   return NULL;  // If we get here, no element's data meets the criteria
                 // dicated by the predicate
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// FindElementEx function
+
+LPPOSITION FindElementEx(LPPOSITION lpElement, void* pvSearchKey,
+    LPCOMPARE_ROUTINE_EX lpfnCompare, void* pvContext) {
+  if (lpElement == NULL || lpfnCompare == NULL) {
+    return NULL;  // Required parameters
+  }
+
+  MoveToHeadPosition(&lpElement);
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    LIST_STATS_COUNT(nComparisons, 1);
+    if (lpfnCompare(pvSearchKey, lpElement->pvData, pvContext)) {
+      return lpElement;
+    }
+  }
+
+  return NULL;  // If we get here, no element's data meets the criteria
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // FindElementWhere function
 
@@ -150,16 +655,41 @@ LPPOSITION FindElementWhere(LPPOSITION lpElement,
   }
 
   MoveToHeadPosition(&lpElement);
-  do {
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    LIST_STATS_COUNT(nComparisons, 1);
     if (lpfnPredicate(lpElement->pvData)) {
       return lpElement;
     }
-  } while ((lpElement = lpElement->pNext) != NULL);
+  }
 
   return NULL;  // If we get here, no element's data meets the criteria
                 // dicated by the predicate
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// FindElementWhereEx function
+
+LPPOSITION FindElementWhereEx(LPPOSITION lpElement,
+    LPPREDICATE_ROUTINE_EX lpfnPredicate, void* pvContext) {
+  if (lpElement == NULL || lpfnPredicate == NULL) {
+    return NULL;  // Required parameters
+  }
+
+  MoveToHeadPosition(&lpElement);
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    LIST_STATS_COUNT(nComparisons, 1);
+    if (lpfnPredicate(lpElement->pvData, pvContext)) {
+      return lpElement;
+    }
+  }
+
+  return NULL;  // If we get here, no element's data meets the criteria
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // GetElementCount function
 
@@ -170,9 +700,13 @@ int GetElementCount(LPPOSITION lpElement) {
   }
 
   MoveToHeadPosition(&lpElement);
-  do {
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, FALSE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
     nResult++;
-  } while ((lpElement = lpElement->pNext) != NULL);
+  }
+
+  LIST_STATS_LENGTH(NULL, nResult);
 
   return nResult;
 }
@@ -192,10 +726,36 @@ int GetElementCountWhere(LPPOSITION lpElement,
   }
 
   MoveToHeadPosition(&lpElement);
-  do {
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    LIST_STATS_COUNT(nComparisons, 1);
     if (lpfnPredicate(lpElement->pvData))
       nResult++;
-  } while ((lpElement = lpElement->pNext) != NULL);
+  }
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetElementCountWhereEx function
+
+int GetElementCountWhereEx(LPPOSITION lpElement,
+    LPPREDICATE_ROUTINE_EX lpfnPredicate, void* pvContext) {
+  int nResult = 0;
+  if (lpElement == NULL || lpfnPredicate == NULL) {
+    return nResult;
+  }
+
+  MoveToHeadPosition(&lpElement);
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    LIST_STATS_COUNT(nComparisons, 1);
+    if (lpfnPredicate(lpElement->pvData, pvContext)) {
+      nResult++;
+    }
+  }
 
   return nResult;
 }
@@ -217,6 +777,8 @@ void RemoveElement(LPPPOSITION lppElement,
   // routine
   lpfnDealloc((*lppElement)->pvData);
 
+  LIST_STATS_COUNT(nFrees, 1);
+
   // Remove the single element that is in the list
   if (IsSoleElement(*lppElement)) {
     free(*lppElement);
@@ -252,60 +814,249 @@ void RemoveElement(LPPPOSITION lppElement,
 ///////////////////////////////////////////////////////////////////////////////
 // RemoveElementWhere function
 
-void RemoveElementWhere(LPPPOSITION lppElement,
+int RemoveElementWhere(LPPPOSITION lppElement,
     void* pvSearchKey, LPCOMPARE_ROUTINE lpfnCompareFunc,
     LPDEALLOC_ROUTINE lpfnDeallocFunc) {
   if (lppElement == NULL || *lppElement == NULL) {
-    return; // Nothing to do.
+    return 0; // Nothing to do.
   }
 
   if (pvSearchKey == NULL) {
-    return; // Required parameter
+    return 0; // Required parameter
   }
 
   if (lpfnCompareFunc == NULL) {
-    return; // Required parameter
+    return 0; // Required parameter
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return 0; // Required parameter
+  }
+
+  MATCH_CRITERIA criteria = { 0 };
+  criteria.pvSearchKey = pvSearchKey;
+  criteria.lpfnCompare = lpfnCompareFunc;
+
+  return RemovePositionsWhere(lppElement, &criteria, lpfnDeallocFunc);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RemoveElementWhereEx function
+
+int RemoveElementWhereEx(LPPPOSITION lppElement, void* pvSearchKey,
+    LPCOMPARE_ROUTINE_EX lpfnCompareFunc, void* pvContext,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppElement == NULL || *lppElement == NULL) {
+    return 0; // Nothing to do.
+  }
+
+  if (lpfnCompareFunc == NULL || lpfnDeallocFunc == NULL) {
+    return 0; // Required parameters
+  }
+
+  MATCH_CRITERIA criteria = { 0 };
+  criteria.pvSearchKey = pvSearchKey;
+  criteria.lpfnCompareEx = lpfnCompareFunc;
+  criteria.pvContext = pvContext;
+
+  return RemovePositionsWhere(lppElement, &criteria, lpfnDeallocFunc);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RemoveElementWherePredicate function
+
+int RemoveElementWherePredicate(LPPPOSITION lppElement,
+    LPPREDICATE_ROUTINE lpfnPredicate, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppElement == NULL || *lppElement == NULL) {
+    return 0; // Nothing to do.
+  }
+
+  if (lpfnPredicate == NULL) {
+    return 0; // Required parameter
   }
 
   if (lpfnDeallocFunc == NULL) {
+    return 0; // Required parameter
+  }
+
+  MATCH_CRITERIA criteria = { 0 };
+  criteria.lpfnPredicate = lpfnPredicate;
+
+  return RemovePositionsWhere(lppElement, &criteria, lpfnDeallocFunc);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RemoveElementWherePredicateEx function
+
+int RemoveElementWherePredicateEx(LPPPOSITION lppElement,
+    LPPREDICATE_ROUTINE_EX lpfnPredicate, void* pvContext,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppElement == NULL || *lppElement == NULL) {
+    return 0; // Nothing to do.
+  }
+
+  if (lpfnPredicate == NULL || lpfnDeallocFunc == NULL) {
+    return 0; // Required parameters
+  }
+
+  MATCH_CRITERIA criteria = { 0 };
+  criteria.lpfnPredicateEx = lpfnPredicate;
+  criteria.pvContext = pvContext;
+
+  return RemovePositionsWhere(lppElement, &criteria, lpfnDeallocFunc);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SortList function
+
+void SortList(LPPPOSITION lppElement, LPSORT_COMPARE_ROUTINE lpfnCompare) {
+  if (lppElement == NULL || *lppElement == NULL) {
+    return; // Nothing to do
+  }
+
+  if (lpfnCompare == NULL) {
     return; // Required parameter
   }
 
-  /*
-   * Kind of brute force...search the list over and over
-   * again for elements that match our search key, using our
-   * comparison callback. Once the FindElement function reports
-   * NULL (as in not found), then quit.
-   */
+  /* apRuns[i] is either NULL or a sorted run of 2^i nodes, and holds nodes
+   that came before those of any lower-numbered run.  Each node taken from
+   the list is merged upward like a carry in binary addition, so runs of equal
+   size are always merged, and the sort needs no extra memory beyond this
+   fixed array. */
+  LPPOSITION apRuns[64] = { NULL };
+  int nRunCount = 0;
+
+  MoveToHeadPosition(lppElement);
+
+  LPPOSITION lpElement = *lppElement;
+  while (lpElement != NULL) {
+    LPPOSITION lpRun = lpElement;
+    lpElement = lpElement->pNext;
+    lpRun->pNext = NULL;
+
+    int i = 0;
+    for (; i < nRunCount && apRuns[i] != NULL; i++) {
+      lpRun = MergeSortedRuns(apRuns[i], lpRun, lpfnCompare);
+      apRuns[i] = NULL;
+    }
+
+    if (i == nRunCount) {
+      nRunCount++;
+    }
+
+    apRuns[i] = lpRun;
+  }
 
-  do {
-    *lppElement = FindElement(*lppElement,
-        pvSearchKey, lpfnCompareFunc);
-    if (*lppElement == NULL) {
-      break;  // Not found
+  LPPOSITION lpHead = NULL;
+  for (int i = 0; i < nRunCount; i++) {
+    if (apRuns[i] != NULL) {
+      lpHead = MergeSortedRuns(apRuns[i], lpHead, lpfnCompare);
     }
-    RemoveElement(lppElement, lpfnDeallocFunc);
-  } while (TRUE);
+  }
+
+  /* The merges only maintain the pNext links; restore the pPrev links in a
+   single pass. */
+  LPPOSITION lpPrev = NULL;
+  for (lpElement = lpHead; lpElement != NULL; lpElement = lpElement->pNext) {
+    lpElement->pPrev = lpPrev;
+    lpPrev = lpElement;
+  }
+
+  *lppElement = lpHead;
 }
 
-///////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+// SpliceElements function
+
+void SpliceElements(LPPPOSITION lppDestination, LPPOSITION lpAfter,
+    LPPOSITION lpFirst, LPPOSITION lpLast) {
+  if (lppDestination == NULL || lpFirst == NULL || lpLast == NULL) {
+    return; // Required parameters
+  }
+
+  // Close the gap that the range leaves in the list it comes from
+  if (lpFirst->pPrev != NULL) {
+    lpFirst->pPrev->pNext = lpLast->pNext;
+  }
+  if (lpLast->pNext != NULL) {
+    lpLast->pNext->pPrev = lpFirst->pPrev;
+  }
+
+  LPPOSITION lpBefore = NULL;
+  if (lpAfter != NULL) {
+    lpBefore = lpAfter->pNext;
+    lpAfter->pNext = lpFirst;
+  } else if (*lppDestination != NULL) {
+    MoveToHeadPosition(lppDestination);
+    lpBefore = *lppDestination;
+  }
+
+  lpFirst->pPrev = lpAfter;
+  lpLast->pNext = lpBefore;
+  if (lpBefore != NULL) {
+    lpBefore->pPrev = lpLast;
+  }
+
+  if (lpAfter == NULL) {
+    *lppDestination = lpFirst;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SplitList function
+
+LPPOSITION SplitList(LPPOSITION lpElement) {
+  if (lpElement == NULL || lpElement->pPrev == NULL) {
+    return NULL; // Nothing to do
+  }
+
+  LPPOSITION lpTail = lpElement->pPrev;
+  lpTail->pNext = NULL;
+  lpElement->pPrev = NULL;
+
+  return lpTail;
+}
+
+//////////////////////////////////////////////////////////////////////////////
 // Sum function
 
 int SumElements(LPPOSITION lpElement, LPSUMMATION_ROUTINE lpfnSumRoutine)
 {
-  int nResult = -1;
+  int nResult = 0;
   if (lpElement == NULL) {
-    return nResult;  // Required parameter
+    return ERROR;  // Required parameter
   }
 
   if (lpfnSumRoutine == NULL) {
-    return nResult;  // Required parameter
+    return ERROR;  // Required parameter
   }
 
   MoveToHeadPosition(&lpElement);
-  do {
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
     nResult += lpfnSumRoutine(lpElement->pvData);
-  } while ((lpElement = lpElement->pNext) != NULL);
+  }
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumElementsEx function
+
+int SumElementsEx(LPPOSITION lpElement, LPSUMMATION_ROUTINE_EX lpfnSumRoutine,
+    void* pvContext) {
+  int nResult = 0;
+  if (lpElement == NULL || lpfnSumRoutine == NULL) {
+    return ERROR;  // Required parameters
+  }
+
+  MoveToHeadPosition(&lpElement);
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    nResult += lpfnSumRoutine(lpElement->pvData, pvContext);
+  }
 
   return nResult;
 }
@@ -335,13 +1086,55 @@ int SumElementsWhere(LPPOSITION lpElement, LPSUMMATION_ROUTINE lpfnSumRoutine,
     return nResult; // Unable to move to head of list, so sum is zero
   }
 
-  do {
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    LIST_STATS_COUNT(nComparisons, 1);
     if (!lpfnCompareRoutine(pvSearchKey, lpElement->pvData)) {
       continue; // Skip elements for which criteria is not met
     }
     nResult += lpfnSumRoutine(lpElement->pvData);
-  } while ((lpElement = GetNextPosition(lpElement)) != NULL);
+  }
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumElementsWhereEx function
+
+int SumElementsWhereEx(LPPOSITION lpElement,
+    LPSUMMATION_ROUTINE_EX lpfnSumRoutine, void* pvSearchKey,
+    LPCOMPARE_ROUTINE_EX lpfnCompareRoutine, void* pvContext) {
+  int nResult = 0;
+
+  if (lpElement == NULL) {
+    return nResult; // No elements in linked list at all; sum is obviously 0
+  }
+
+  if (lpfnSumRoutine == NULL || lpfnCompareRoutine == NULL) {
+    return ERROR; // Required parameters
+  }
+
+  MoveToHeadPosition(&lpElement);
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    LIST_STATS_COUNT(nComparisons, 1);
+    if (lpfnCompareRoutine(pvSearchKey, lpElement->pvData, pvContext)) {
+      nResult += lpfnSumRoutine(lpElement->pvData, pvContext);
+    }
+  }
 
   return nResult;
 }
+
 //////////////////////////////////////////////////////////////////////////////
+// WaitForAsyncClears function
+
+void WaitForAsyncClears(void) {
+  pthread_mutex_lock(&g_asyncClearMutex);
+  while (g_nPendingAsyncClears > 0) {
+    pthread_cond_wait(&g_asyncClearDone, &g_asyncClearMutex);
+  }
+  pthread_mutex_unlock(&g_asyncClearMutex);
+}
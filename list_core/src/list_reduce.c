@@ -0,0 +1,183 @@
+// list_reduce.c - Implementations of functions that reduce the elements of a
+// linked list to a single value
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "list_reduce.h"
+#include "list_traversal.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// ReduceElements function
+
+void ReduceElements(LPPOSITION lpElement, void* pvAccumulator,
+    LPREDUCE_ROUTINE lpfnReduce, void* pvContext) {
+  if (lpElement == NULL || lpfnReduce == NULL) {
+    return; // Nothing to do
+  }
+
+  MoveToHeadPosition(&lpElement);
+  TRAVERSAL_CURSOR cursor;
+  BeginTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    lpfnReduce(pvAccumulator, lpElement->pvData, pvContext);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumDoubleValues function
+
+double SumDoubleValues(const double* pdValues, int nCount) {
+  if (pdValues == NULL || nCount <= 0) {
+    return 0.0;
+  }
+
+  /* Floating-point addition is not associative, so the compiler may not
+   split a single running sum on its own; four explicit partial sums give it
+   independent chains to work with. */
+  double adPartial[4] = { 0.0, 0.0, 0.0, 0.0 };
+  int i = 0;
+
+  for (; i + 4 <= nCount; i += 4) {
+    adPartial[0] += pdValues[i];
+    adPartial[1] += pdValues[i + 1];
+    adPartial[2] += pdValues[i + 2];
+    adPartial[3] += pdValues[i + 3];
+  }
+
+  for (; i < nCount; i++) {
+    adPartial[0] += pdValues[i];
+  }
+
+  return (adPartial[0] + adPartial[1]) + (adPartial[2] + adPartial[3]);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumElementsDouble function
+
+double SumElementsDouble(LPPOSITION lpElement,
+    LPDOUBLE_VALUE_ROUTINE lpfnValue) {
+  double dResult = 0.0;
+
+  if (lpElement == NULL || lpfnValue == NULL) {
+    return dResult; // Required parameters
+  }
+
+  MoveToHeadPosition(&lpElement);
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    dResult += lpfnValue(lpElement->pvData);
+  }
+
+  return dResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumElementsInt64 function
+
+int64_t SumElementsInt64(LPPOSITION lpElement,
+    LPINT64_VALUE_ROUTINE lpfnValue) {
+  int64_t nResult = 0;
+
+  if (lpElement == NULL || lpfnValue == NULL) {
+    return nResult; // Required parameters
+  }
+
+  MoveToHeadPosition(&lpElement);
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    nResult += lpfnValue(lpElement->pvData);
+  }
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumElementsWhereDouble function
+
+double SumElementsWhereDouble(LPPOSITION lpElement,
+    LPDOUBLE_VALUE_ROUTINE lpfnValue, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareRoutine) {
+  double dResult = 0.0;
+
+  if (lpElement == NULL || lpfnValue == NULL || lpfnCompareRoutine == NULL) {
+    return dResult; // Required parameters
+  }
+
+  MoveToHeadPosition(&lpElement);
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    if (lpfnCompareRoutine(pvSearchKey, lpElement->pvData)) {
+      dResult += lpfnValue(lpElement->pvData);
+    }
+  }
+
+  return dResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumElementsWhereInt64 function
+
+int64_t SumElementsWhereInt64(LPPOSITION lpElement,
+    LPINT64_VALUE_ROUTINE lpfnValue, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareRoutine) {
+  int64_t nResult = 0;
+
+  if (lpElement == NULL || lpfnValue == NULL || lpfnCompareRoutine == NULL) {
+    return nResult; // Required parameters
+  }
+
+  MoveToHeadPosition(&lpElement);
+  TRAVERSAL_CURSOR cursor;
+  BeginReadAheadTraversal(&cursor, lpElement, TRUE);
+  while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+    if (lpfnCompareRoutine(pvSearchKey, lpElement->pvData)) {
+      nResult += lpfnValue(lpElement->pvData);
+    }
+  }
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumInt64Values function
+
+int64_t SumInt64Values(const int64_t* pnValues, int nCount) {
+  int64_t nResult = 0;
+
+  if (pnValues == NULL || nCount <= 0) {
+    return nResult;
+  }
+
+  /* A plain loop over a contiguous array, with no calls or aliasing stores,
+   which the compiler is able to vectorize. */
+  for (int i = 0; i < nCount; i++) {
+    nResult += pnValues[i];
+  }
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,1172 @@
+// list_root.c - Implementations of functions that manipulate a doubly-linked
+// list by means of a LIST_ROOT structure
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "position.h"
+#include "list_root.h"
+#include "position_pool.h"
+#include "hash_index.h"
+#include "list_teardown.h"
+#include "list_stats_internal.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AllocRootPosition function - Allocates a node, either from the root's pool,
+// if it has one, or from the heap.
+
+static void AllocRootPosition(LPLIST_ROOT lpRoot, LPPPOSITION lppPosition) {
+  LIST_STATS_BEGIN(&(lpRoot->stats));
+
+  if (lpRoot->lpPool != NULL) {
+    AllocPoolPosition(lpRoot->lpPool, lppPosition);
+  } else {
+    CreatePosition(lppPosition);
+  }
+
+  LIST_STATS_END();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FreeRootPosition function - Gives a node back to whichever allocator it was
+// obtained from.
+
+static void FreeRootPosition(LPLIST_ROOT lpRoot, LPPPOSITION lppPosition) {
+  LIST_STATS_BEGIN(&(lpRoot->stats));
+
+  if (lpRoot->lpPool != NULL) {
+    FreePoolPosition(lpRoot->lpPool, lppPosition);
+  } else {
+    DestroyPosition(lppPosition);
+  }
+
+  LIST_STATS_END();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// EndRootCompaction function - Abandons any incremental compaction of the
+// list that is under way, and gives the unused nodes of its block back to the
+// root's pool.
+
+static void EndRootCompaction(LPLIST_ROOT lpRoot) {
+  LPROOT_COMPACTION lpCompaction = &(lpRoot->compaction);
+  if (lpCompaction->pBlock == NULL) {
+    return; // Nothing to do
+  }
+
+  for (int i = lpCompaction->nUsed; i < lpCompaction->nCapacity; i++) {
+    LPPOSITION lpUnused = &(lpCompaction->pBlock[i]);
+    FreePoolPosition(lpRoot->lpPool, &lpUnused);
+  }
+
+  memset(lpCompaction, 0, sizeof(ROOT_COMPACTION));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// IndexRootPosition function - Adds a node to the root's hash index, if it
+// has one.  The node's data must already have been set.
+
+static BOOL IndexRootPosition(LPLIST_ROOT lpRoot, LPPOSITION lpPosition) {
+  if (lpRoot->lpIndex == NULL) {
+    return TRUE;
+  }
+
+  return AddHashIndexEntry(lpRoot->lpIndex, lpPosition);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// IsCompactedPosition function - Determines whether a node has already been
+// moved into the block of the compaction that is under way.
+
+static BOOL IsCompactedPosition(LPLIST_ROOT lpRoot, LPPOSITION lpElement) {
+  LPROOT_COMPACTION lpCompaction = &(lpRoot->compaction);
+
+  return lpElement >= lpCompaction->pBlock
+      && lpElement < lpCompaction->pBlock + lpCompaction->nUsed;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// LinkRootPosition function - Inserts an already-allocated node after the
+// element specified (or at the head, if lpAfter is NULL), and updates the
+// root's bookkeeping.
+
+static void LinkRootPosition(LPLIST_ROOT lpRoot, LPPOSITION lpAfter,
+    LPPOSITION lpNew) {
+  if (lpAfter == NULL) {
+    lpNew->pPrev = NULL;
+    lpNew->pNext = lpRoot->pHead;
+    if (lpRoot->pHead != NULL) {
+      lpRoot->pHead->pPrev = lpNew;
+    }
+    lpRoot->pHead = lpNew;
+  } else {
+    lpNew->pPrev = lpAfter;
+    lpNew->pNext = lpAfter->pNext;
+    if (lpAfter->pNext != NULL) {
+      lpAfter->pNext->pPrev = lpNew;
+    }
+    lpAfter->pNext = lpNew;
+  }
+
+  if (lpNew->pNext == NULL) {
+    lpRoot->pTail = lpNew;
+  }
+
+  lpRoot->nCount++;
+
+  LIST_STATS_LENGTH(&(lpRoot->stats), lpRoot->nCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// UnlinkRootPosition function - Detaches a node from the list without
+// deallocating it, and updates the root's bookkeeping.
+
+static void UnlinkRootPosition(LPLIST_ROOT lpRoot, LPPOSITION lpElement) {
+  if (lpRoot->lpIndex != NULL) {
+    RemoveHashIndexEntry(lpRoot->lpIndex, lpElement);
+  }
+
+  if (lpElement == lpRoot->compaction.pLastMoved) {
+    lpRoot->compaction.pLastMoved = lpElement->pPrev;
+  }
+
+  if (lpElement->pPrev != NULL) {
+    lpElement->pPrev->pNext = lpElement->pNext;
+  } else {
+    lpRoot->pHead = lpElement->pNext;
+  }
+
+  if (lpElement->pNext != NULL) {
+    lpElement->pNext->pPrev = lpElement->pPrev;
+  } else {
+    lpRoot->pTail = lpElement->pPrev;
+  }
+
+  lpElement->pPrev = NULL;
+  lpElement->pNext = NULL;
+
+  lpRoot->nCount--;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// MoveRootPosition function - Puts a new node in the place of an element of
+// the list, taking over its data, its links and its entry in the root's hash
+// index.  The old node is left for the caller to deallocate.
+
+static void MoveRootPosition(LPLIST_ROOT lpRoot, LPPOSITION lpOld,
+    LPPOSITION lpNew) {
+  if (lpRoot->lpIndex != NULL) {
+    RemoveHashIndexEntry(lpRoot->lpIndex, lpOld);
+  }
+
+  lpNew->pvData = lpOld->pvData;
+  lpNew->pPrev = lpOld->pPrev;
+  lpNew->pNext = lpOld->pNext;
+
+  if (lpNew->pPrev != NULL) {
+    lpNew->pPrev->pNext = lpNew;
+  } else {
+    lpRoot->pHead = lpNew;
+  }
+
+  if (lpNew->pNext != NULL) {
+    lpNew->pNext->pPrev = lpNew;
+  } else {
+    lpRoot->pTail = lpNew;
+  }
+
+  if (lpRoot->lpIndex != NULL) {
+    /* Cannot fail, since the entry just removed leaves room for this one. */
+    AddHashIndexEntry(lpRoot->lpIndex, lpNew);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveRootPositionsWhere function - Walks the list once from the head, and
+// removes each node that matches either the search key (according to
+// lpfnCompare) or the predicate, whichever one is specified.
+
+static int RemoveRootPositionsWhere(LPLIST_ROOT lpRoot, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompare, LPPREDICATE_ROUTINE lpfnPredicate,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  int nRemoved = 0;
+  LPPOSITION lpElement = NULL;
+
+  LIST_STATS_BEGIN(&(lpRoot->stats));
+
+  if (lpfnCompare != NULL && lpRoot->lpIndex != NULL
+      && lpRoot->lpIndex->lpfnCompare == lpfnCompare) {
+    /* The index leads straight to each of the matching nodes, so there is
+     no need to visit the others. */
+    while ((lpElement = FindHashIndexEntry(lpRoot->lpIndex, pvSearchKey))
+        != NULL) {
+      UnlinkRootPosition(lpRoot, lpElement);
+      lpfnDeallocFunc(lpElement->pvData);
+      FreeRootPosition(lpRoot, &lpElement);
+      nRemoved++;
+    }
+
+    LIST_STATS_END();
+    return nRemoved;
+  }
+
+  lpElement = lpRoot->pHead;
+
+  while (lpElement != NULL) {
+    LPPOSITION lpNext = lpElement->pNext;
+
+    LIST_STATS_COUNT(nNodesTraversed, 1);
+    LIST_STATS_COUNT(nComparisons, 1);
+    BOOL bMatch = lpfnCompare != NULL
+        ? lpfnCompare(pvSearchKey, lpElement->pvData)
+        : lpfnPredicate(lpElement->pvData);
+    if (bMatch) {
+      UnlinkRootPosition(lpRoot, lpElement);
+      lpfnDeallocFunc(lpElement->pvData);
+      FreeRootPosition(lpRoot, &lpElement);
+      nRemoved++;
+    }
+
+    lpElement = lpNext;
+  }
+
+  LIST_STATS_END();
+
+  return nRemoved;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AreRootAllocatorsCompatible function - Determines whether nodes can be
+// moved from one list to the other, i.e., whether the destination can give
+// them back to the allocator they came from.
+
+static BOOL AreRootAllocatorsCompatible(LPLIST_ROOT lpDestination,
+    LPLIST_ROOT lpSource) {
+  if (lpDestination == lpSource) {
+    return TRUE;
+  }
+
+  return lpDestination->lpPool == lpSource->lpPool
+      && !lpDestination->bOwnsPool && !lpSource->bOwnsPool;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CountRootElementsFrom function - Counts the elements from the one specified
+// to the tail, by walking outwards in both directions until either end of the
+// list is reached.
+
+static int CountRootElementsFrom(LPLIST_ROOT lpRoot, LPPOSITION lpElement) {
+  LPPOSITION lpForward = lpElement;
+  LPPOSITION lpBackward = lpElement->pPrev;
+  int nSteps = 0;
+
+  while (lpForward != NULL && lpBackward != NULL) {
+    lpForward = lpForward->pNext;
+    lpBackward = lpBackward->pPrev;
+    nSteps++;
+  }
+
+  LIST_STATS_COUNT(nNodesTraversed, 2 * nSteps);
+
+  // nSteps is now the length of whichever side ran out first
+  return lpForward == NULL ? nSteps : lpRoot->nCount - nSteps;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// IndexRootRange function - Adds the elements of a range to the root's hash
+// index, if it has one, and counts them.  If the index cannot be grown, the
+// elements already added are taken out again.  Returns the count, or ERROR.
+
+static int IndexRootRange(LPLIST_ROOT lpRoot, LPPOSITION lpFirst,
+    LPPOSITION lpLast) {
+  int nCount = 0;
+
+  for (LPPOSITION lpElement = lpFirst; ; lpElement = lpElement->pNext) {
+    if (!IndexRootPosition(lpRoot, lpElement)) {
+      for (; lpFirst != lpElement; lpFirst = lpFirst->pNext) {
+        RemoveHashIndexEntry(lpRoot->lpIndex, lpFirst);
+      }
+      return ERROR;
+    }
+
+    nCount++;
+    if (lpElement == lpLast) {
+      break;
+    }
+  }
+
+  LIST_STATS_COUNT(nNodesTraversed, nCount);
+
+  return nCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// MoveRootRange function - Unlinks a range of elements from one list and
+// links it into another (or the same one) after lpAfter, or at the head if
+// lpAfter is NULL.  The roots' counts are left to the caller.
+
+static void MoveRootRange(LPLIST_ROOT lpDestination, LPPOSITION lpAfter,
+    LPLIST_ROOT lpSource, LPPOSITION lpFirst, LPPOSITION lpLast) {
+  if (lpFirst->pPrev != NULL) {
+    lpFirst->pPrev->pNext = lpLast->pNext;
+  } else {
+    lpSource->pHead = lpLast->pNext;
+  }
+
+  if (lpLast->pNext != NULL) {
+    lpLast->pNext->pPrev = lpFirst->pPrev;
+  } else {
+    lpSource->pTail = lpFirst->pPrev;
+  }
+
+  LPPOSITION lpBefore = lpAfter != NULL ? lpAfter->pNext
+      : lpDestination->pHead;
+
+  lpFirst->pPrev = lpAfter;
+  lpLast->pNext = lpBefore;
+
+  if (lpAfter != NULL) {
+    lpAfter->pNext = lpFirst;
+  } else {
+    lpDestination->pHead = lpFirst;
+  }
+
+  if (lpBefore != NULL) {
+    lpBefore->pPrev = lpLast;
+  } else {
+    lpDestination->pTail = lpLast;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AddRootElement function
+
+LPPOSITION AddRootElement(LPLIST_ROOT lpRoot, LPPOSITION lpAfter,
+    void* pvData) {
+  if (lpRoot == NULL) {
+    return NULL; // Required parameter
+  }
+
+  LPPOSITION lpNew = NULL;
+
+  AllocRootPosition(lpRoot, &lpNew);
+  if (lpNew == NULL) {
+    fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+    return NULL;
+  }
+
+  SetPositionData(lpNew, pvData);
+
+  if (!IndexRootPosition(lpRoot, lpNew)) {
+    fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+    FreeRootPosition(lpRoot, &lpNew);
+    return NULL;
+  }
+
+  LinkRootPosition(lpRoot, lpAfter, lpNew);
+
+  return lpNew;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AddRootElementsFromArray function
+
+int AddRootElementsFromArray(LPLIST_ROOT lpRoot, void** ppvData, int nCount) {
+  int nAdded = 0;
+
+  if (lpRoot == NULL || ppvData == NULL || nCount <= 0) {
+    return nAdded; // Required parameters
+  }
+
+  LIST_STATS_BEGIN(&(lpRoot->stats));
+
+  LPPOSITION lpBlock = NULL;
+  if (lpRoot->lpPool != NULL) {
+    AllocPoolPositions(lpRoot->lpPool, nCount, &lpBlock);
+    if (lpBlock == NULL) {
+      fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+      LIST_STATS_END();
+      return nAdded;
+    }
+  }
+
+  for (; nAdded < nCount; nAdded++) {
+    LPPOSITION lpNew = NULL;
+
+    if (lpBlock != NULL) {
+      lpNew = &(lpBlock[nAdded]);
+    } else {
+      CreatePosition(&lpNew);
+      if (lpNew == NULL) {
+        fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+        break;
+      }
+    }
+
+    lpNew->pvData = ppvData[nAdded];
+
+    if (!IndexRootPosition(lpRoot, lpNew)) {
+      fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+      if (lpBlock == NULL) {
+        FreeRootPosition(lpRoot, &lpNew);
+      }
+      break;
+    }
+
+    LinkRootPosition(lpRoot, lpRoot->pTail, lpNew);
+  }
+
+  // Gives the nodes of the block that were not linked back to the pool
+  if (lpBlock != NULL) {
+    for (int i = nAdded; i < nCount; i++) {
+      LPPOSITION lpUnused = &(lpBlock[i]);
+      FreeRootPosition(lpRoot, &lpUnused);
+    }
+  }
+
+  LIST_STATS_END();
+
+  return nAdded;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AddRootElementSorted function
+
+LPPOSITION AddRootElementSorted(LPLIST_ROOT lpRoot, void* pvData,
+    LPSORT_COMPARE_ROUTINE lpfnCompare) {
+  if (lpRoot == NULL || lpfnCompare == NULL) {
+    return NULL; // Required parameters
+  }
+
+  LIST_STATS_BEGIN(&(lpRoot->stats));
+
+  LPPOSITION lpAfter = lpRoot->pTail;
+  if (lpAfter != NULL) {
+    LIST_STATS_COUNT(nComparisons, 1);
+  }
+
+  if (lpAfter != NULL && lpfnCompare(lpAfter->pvData, pvData) > 0) {
+    /* Find the last element that does not sort after the new data; the new
+     element goes right after it, or at the head if there is no such
+     element. */
+    lpAfter = NULL;
+    LPPOSITION lpElement = lpRoot->pHead;
+    while (TRUE) {
+      LIST_STATS_COUNT(nNodesTraversed, 1);
+      LIST_STATS_COUNT(nComparisons, 1);
+      if (lpfnCompare(lpElement->pvData, pvData) > 0) {
+        break;
+      }
+      lpAfter = lpElement;
+      lpElement = lpElement->pNext;
+    }
+  }
+
+  LPPOSITION lpResult = AddRootElement(lpRoot, lpAfter, pvData);
+
+  LIST_STATS_END();
+
+  return lpResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AddRootElementToHead function
+
+LPPOSITION AddRootElementToHead(LPLIST_ROOT lpRoot, void* pvData) {
+  return AddRootElement(lpRoot, NULL, pvData);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AddRootElementToTail function
+
+LPPOSITION AddRootElementToTail(LPLIST_ROOT lpRoot, void* pvData) {
+  if (lpRoot == NULL) {
+    return NULL; // Required parameter
+  }
+
+  return AddRootElement(lpRoot, lpRoot->pTail, pvData);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AttachRootHashIndex function
+
+BOOL AttachRootHashIndex(LPLIST_ROOT lpRoot, LPHASH_ROUTINE lpfnHash,
+    LPCOMPARE_ROUTINE lpfnCompare) {
+  if (lpRoot == NULL || lpfnHash == NULL || lpfnCompare == NULL) {
+    return FALSE; // Required parameters
+  }
+
+  LPHASH_INDEX lpIndex = NULL;
+
+  CreateHashIndex(&lpIndex, lpfnHash, lpfnCompare, lpRoot->nCount);
+  if (lpIndex == NULL) {
+    return FALSE;
+  }
+
+  LPPOSITION lpElement = lpRoot->pHead;
+  while (lpElement != NULL) {
+    if (!AddHashIndexEntry(lpIndex, lpElement)) {
+      DestroyHashIndex(&lpIndex);
+      return FALSE;
+    }
+    lpElement = lpElement->pNext;
+  }
+
+  DetachRootHashIndex(lpRoot);
+  lpRoot->lpIndex = lpIndex;
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ClearListRoot function
+
+void ClearListRoot(LPLIST_ROOT lpRoot, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpRoot == NULL || lpRoot->pHead == NULL) {
+    return; // Nothing to do
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  EndRootCompaction(lpRoot);
+
+  LIST_STATS_BEGIN(&(lpRoot->stats));
+
+  if (lpRoot->lpPool == NULL) {
+    ClearList(&(lpRoot->pHead), lpfnDeallocFunc);
+  } else if (lpRoot->bOwnsPool) {
+    /* Every node in a private pool belongs to this list, so once the
+     data have been deallocated, the nodes can be released all at once. */
+    LPPOSITION lpElement = lpRoot->pHead;
+    while (lpElement != NULL) {
+      lpfnDeallocFunc(lpElement->pvData);
+      lpElement = lpElement->pNext;
+    }
+    ResetPositionPool(lpRoot->lpPool);
+  } else {
+    LPPOSITION lpElement = lpRoot->pHead;
+    while (lpElement != NULL) {
+      LPPOSITION lpNext = lpElement->pNext;
+      lpfnDeallocFunc(lpElement->pvData);
+      FreePoolPosition(lpRoot->lpPool, &lpElement);
+      lpElement = lpNext;
+    }
+  }
+
+  LIST_STATS_END();
+
+  ClearHashIndex(lpRoot->lpIndex);
+
+  lpRoot->pHead = NULL;
+  lpRoot->pTail = NULL;
+  lpRoot->nCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ClearListRootAsync function
+
+void ClearListRootAsync(LPLIST_ROOT lpRoot,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpRoot == NULL || lpRoot->pHead == NULL) {
+    return; // Nothing to do
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  if (lpRoot->lpPool != NULL && !lpRoot->bOwnsPool) {
+    ClearListRoot(lpRoot, lpfnDeallocFunc);
+    return;
+  }
+
+  EndRootCompaction(lpRoot);
+
+  /* The nodes of a private pool go with the pool, so the root needs a new
+   one before the old one can be handed over. */
+  LPPOSITION_POOL lpOldPool = NULL;
+  if (lpRoot->bOwnsPool) {
+    LPPOSITION_POOL lpNewPool = NULL;
+    CreatePositionPool(&lpNewPool, lpRoot->lpPool->nSlabSize,
+        lpRoot->lpPool->bThreadSafe);
+    if (lpNewPool == NULL) {
+      ClearListRoot(lpRoot, lpfnDeallocFunc);
+      return;
+    }
+
+    lpOldPool = lpRoot->lpPool;
+    lpRoot->lpPool = lpNewPool;
+  }
+
+  LPPOSITION lpHead = lpRoot->pHead;
+
+  ClearHashIndex(lpRoot->lpIndex);
+
+  lpRoot->pHead = NULL;
+  lpRoot->pTail = NULL;
+  lpRoot->nCount = 0;
+
+  StartAsyncClear(lpHead, lpfnDeallocFunc, lpOldPool);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CompactListRoot function
+
+BOOL CompactListRoot(LPLIST_ROOT lpRoot) {
+  if (lpRoot == NULL) {
+    return FALSE; // Required parameter
+  }
+
+  EndRootCompaction(lpRoot);
+
+  if (lpRoot->nCount == 0) {
+    return TRUE; // Nothing to do
+  }
+
+  /* A shared pool provides the block itself; otherwise, the block goes into
+   a new private pool, so that a private pool's old slabs can be released
+   once the nodes have moved out of them. */
+  LPPOSITION_POOL lpPool = lpRoot->lpPool;
+  if (lpPool == NULL || lpRoot->bOwnsPool) {
+    lpPool = NULL;
+    CreatePositionPool(&lpPool,
+        lpRoot->lpPool != NULL ? lpRoot->lpPool->nSlabSize : 0,
+        lpRoot->lpPool != NULL ? lpRoot->lpPool->bThreadSafe : FALSE);
+    if (lpPool == NULL) {
+      fprintf(stderr, FAILED_ALLOC_POSITION_POOL);
+      return FALSE;
+    }
+  }
+
+  int nCount = lpRoot->nCount;
+  LPPOSITION lpBlock = NULL;
+  AllocPoolPositions(lpPool, nCount, &lpBlock);
+  if (lpBlock == NULL) {
+    fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+    if (lpPool != lpRoot->lpPool) {
+      DestroyPositionPool(&lpPool);
+    }
+    return FALSE;
+  }
+
+  LPPOSITION lpElement = lpRoot->pHead;
+  for (int i = 0; i < nCount; i++) {
+    LPPOSITION lpNext = lpElement->pNext;
+
+    lpBlock[i].pvData = lpElement->pvData;
+    lpBlock[i].pPrev = i > 0 ? &(lpBlock[i - 1]) : NULL;
+    lpBlock[i].pNext = i < nCount - 1 ? &(lpBlock[i + 1]) : NULL;
+
+    if (!lpRoot->bOwnsPool) {
+      FreeRootPosition(lpRoot, &lpElement);
+    }
+
+    lpElement = lpNext;
+  }
+
+  if (lpRoot->bOwnsPool) {
+    DestroyPositionPool(&(lpRoot->lpPool));
+  }
+
+  if (lpPool != lpRoot->lpPool) {
+    lpRoot->lpPool = lpPool;
+    lpRoot->bOwnsPool = TRUE;
+  }
+
+  lpRoot->pHead = &(lpBlock[0]);
+  lpRoot->pTail = &(lpBlock[nCount - 1]);
+
+  if (lpRoot->lpIndex != NULL) {
+    /* The table already has room for every element, so none of these
+     additions can fail. */
+    ClearHashIndex(lpRoot->lpIndex);
+    for (int i = 0; i < nCount; i++) {
+      AddHashIndexEntry(lpRoot->lpIndex, &(lpBlock[i]));
+    }
+  }
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CompactListRootStep function
+
+int CompactListRootStep(LPLIST_ROOT lpRoot, int nMaxCount) {
+  if (lpRoot == NULL || lpRoot->lpPool == NULL || nMaxCount <= 0) {
+    return ERROR; // Required parameters
+  }
+
+  LPROOT_COMPACTION lpCompaction = &(lpRoot->compaction);
+
+  if (lpCompaction->pBlock == NULL) {
+    if (lpRoot->nCount == 0) {
+      return 0; // Nothing to do
+    }
+
+    AllocPoolPositions(lpRoot->lpPool, lpRoot->nCount,
+        &(lpCompaction->pBlock));
+    if (lpCompaction->pBlock == NULL) {
+      fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+      return ERROR;
+    }
+
+    lpCompaction->nCapacity = lpRoot->nCount;
+    lpCompaction->nUsed = 0;
+    lpCompaction->pLastMoved = NULL;
+  }
+
+  LPPOSITION lpElement = lpCompaction->pLastMoved != NULL
+      ? lpCompaction->pLastMoved->pNext : lpRoot->pHead;
+
+  for (int i = 0; i < nMaxCount && lpElement != NULL
+      && lpCompaction->nUsed < lpCompaction->nCapacity; i++) {
+    /* An element may already be in the block if the list has been
+     reordered since the last step; if so, it stays where it is. */
+    if (!IsCompactedPosition(lpRoot, lpElement)) {
+      LPPOSITION lpNew = &(lpCompaction->pBlock[lpCompaction->nUsed++]);
+      MoveRootPosition(lpRoot, lpElement, lpNew);
+      FreeRootPosition(lpRoot, &lpElement);
+      lpElement = lpNew;
+    }
+
+    lpCompaction->pLastMoved = lpElement;
+    lpElement = lpElement->pNext;
+  }
+
+  if (lpElement == NULL || lpCompaction->nUsed == lpCompaction->nCapacity) {
+    EndRootCompaction(lpRoot);
+    return 0;
+  }
+
+  return lpCompaction->nCapacity - lpCompaction->nUsed;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ConcatenateListRoots function
+
+BOOL ConcatenateListRoots(LPLIST_ROOT lpFirst, LPLIST_ROOT lpSecond) {
+  if (lpFirst == NULL || lpSecond == NULL || lpFirst == lpSecond) {
+    return FALSE; // Required parameters
+  }
+
+  if (lpSecond->pHead == NULL) {
+    return TRUE;  // Nothing to do
+  }
+
+  return SpliceRootElements(lpFirst, lpFirst->pTail, lpSecond,
+      lpSecond->pHead, lpSecond->pTail, lpSecond->nCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateListRoot function
+
+void CreateListRoot(LPPLIST_ROOT lppRoot) {
+  if (lppRoot == NULL) {
+    return; // Required parameter
+  }
+
+  *lppRoot = (LPLIST_ROOT) malloc(sizeof(LIST_ROOT));
+  if (*lppRoot == NULL) {
+    fprintf(stderr, FAILED_ALLOC_LIST_ROOT);
+    return;
+  }
+
+  memset(*lppRoot, 0, sizeof(LIST_ROOT));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateListRootFromArray function
+
+int CreateListRootFromArray(LPPLIST_ROOT lppRoot, void** ppvData, int nCount) {
+  if (lppRoot == NULL) {
+    return 0; // Required parameter
+  }
+
+  CreatePooledListRoot(lppRoot, nCount);
+  if (*lppRoot == NULL) {
+    return 0;
+  }
+
+  return AddRootElementsFromArray(*lppRoot, ppvData, nCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateListRootWithPool function
+
+void CreateListRootWithPool(LPPLIST_ROOT lppRoot, LPPOSITION_POOL lpPool) {
+  if (lppRoot == NULL) {
+    return; // Required parameter
+  }
+
+  if (lpPool == NULL) {
+    *lppRoot = NULL;
+    return; // Required parameter
+  }
+
+  CreateListRoot(lppRoot);
+  if (*lppRoot == NULL) {
+    return;
+  }
+
+  (*lppRoot)->lpPool = lpPool;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreatePooledListRoot function
+
+void CreatePooledListRoot(LPPLIST_ROOT lppRoot, int nSlabSize) {
+  if (lppRoot == NULL) {
+    return; // Required parameter
+  }
+
+  CreateListRoot(lppRoot);
+  if (*lppRoot == NULL) {
+    return;
+  }
+
+  CreatePositionPool(&((*lppRoot)->lpPool), nSlabSize, FALSE);
+  if ((*lppRoot)->lpPool == NULL) {
+    fprintf(stderr, FAILED_ALLOC_POSITION_POOL);
+    free(*lppRoot);
+    *lppRoot = NULL;
+    return;
+  }
+
+  (*lppRoot)->bOwnsPool = TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DestroyListRoot function
+
+void DestroyListRoot(LPPLIST_ROOT lppRoot, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppRoot == NULL || *lppRoot == NULL) {
+    return; // Nothing to do
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  ClearListRoot(*lppRoot, lpfnDeallocFunc);
+  EndRootCompaction(*lppRoot);
+
+  if ((*lppRoot)->bOwnsPool) {
+    DestroyPositionPool(&((*lppRoot)->lpPool));
+  }
+
+  DestroyHashIndex(&((*lppRoot)->lpIndex));
+
+  free(*lppRoot);
+  *lppRoot = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DetachRootHashIndex function
+
+void DetachRootHashIndex(LPLIST_ROOT lpRoot) {
+  if (lpRoot == NULL) {
+    return;
+  }
+
+  DestroyHashIndex(&(lpRoot->lpIndex));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DoForEachRootElement function
+
+void DoForEachRootElement(LPLIST_ROOT lpRoot, LPACTION_ROUTINE lpfnAction) {
+  if (lpRoot == NULL) {
+    return;
+  }
+
+  LIST_STATS_BEGIN(&(lpRoot->stats));
+
+  DoForEach(lpRoot->pHead, lpfnAction);
+
+  LIST_STATS_END();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindRootElement function
+
+LPPOSITION FindRootElement(LPLIST_ROOT lpRoot, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompare) {
+  if (lpRoot == NULL) {
+    return NULL;  // Required parameter
+  }
+
+  LIST_STATS_BEGIN(&(lpRoot->stats));
+
+  LPPOSITION lpResult = NULL;
+  if (lpRoot->lpIndex != NULL && lpfnCompare != NULL
+      && lpRoot->lpIndex->lpfnCompare == lpfnCompare) {
+    lpResult = FindHashIndexEntry(lpRoot->lpIndex, pvSearchKey);
+  } else {
+    lpResult = FindElement(lpRoot->pHead, pvSearchKey, lpfnCompare);
+  }
+
+  LIST_STATS_END();
+
+  return lpResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindRootElementWhere function
+
+LPPOSITION FindRootElementWhere(LPLIST_ROOT lpRoot,
+    LPPREDICATE_ROUTINE lpfnPredicate) {
+  if (lpRoot == NULL) {
+    return NULL;  // Required parameter
+  }
+
+  LIST_STATS_BEGIN(&(lpRoot->stats));
+
+  LPPOSITION lpResult = FindElementWhere(lpRoot->pHead, lpfnPredicate);
+
+  LIST_STATS_END();
+
+  return lpResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetListRootStats function
+
+void GetListRootStats(LPLIST_ROOT lpRoot, LPLIST_STATS lpStats) {
+  if (lpRoot == NULL || lpStats == NULL) {
+    return; // Required parameters
+  }
+
+#ifdef LIST_CORE_ENABLE_STATS
+  CopyListStats(lpStats, &(lpRoot->stats));
+#else
+  memcpy(lpStats, &(lpRoot->stats), sizeof(LIST_STATS));
+#endif //LIST_CORE_ENABLE_STATS
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetRootElementCount function
+
+int GetRootElementCount(LPLIST_ROOT lpRoot) {
+  if (lpRoot == NULL) {
+    return 0;
+  }
+
+  return lpRoot->nCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetRootHead function
+
+LPPOSITION GetRootHead(LPLIST_ROOT lpRoot) {
+  if (lpRoot == NULL) {
+    return NULL;
+  }
+
+  return lpRoot->pHead;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetRootTail function
+
+LPPOSITION GetRootTail(LPLIST_ROOT lpRoot) {
+  if (lpRoot == NULL) {
+    return NULL;
+  }
+
+  return lpRoot->pTail;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveRootElement function
+
+LPPOSITION RemoveRootElement(LPLIST_ROOT lpRoot, LPPOSITION lpElement,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpRoot == NULL || lpElement == NULL) {
+    return NULL; // Required parameter
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return NULL; // Required parameter
+  }
+
+  LPPOSITION lpNext = lpElement->pNext;
+
+  UnlinkRootPosition(lpRoot, lpElement);
+
+  lpfnDeallocFunc(lpElement->pvData);
+
+  FreeRootPosition(lpRoot, &lpElement);
+
+  return lpNext;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveRootElementWhere function
+
+int RemoveRootElementWhere(LPLIST_ROOT lpRoot, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareFunc, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpRoot == NULL || lpRoot->pHead == NULL) {
+    return 0; // Nothing to do
+  }
+
+  if (lpfnCompareFunc == NULL || lpfnDeallocFunc == NULL) {
+    return 0; // Required parameters
+  }
+
+  return RemoveRootPositionsWhere(lpRoot, pvSearchKey, lpfnCompareFunc, NULL,
+      lpfnDeallocFunc);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveRootElementWherePredicate function
+
+int RemoveRootElementWherePredicate(LPLIST_ROOT lpRoot,
+    LPPREDICATE_ROUTINE lpfnPredicate, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpRoot == NULL || lpRoot->pHead == NULL) {
+    return 0; // Nothing to do
+  }
+
+  if (lpfnPredicate == NULL || lpfnDeallocFunc == NULL) {
+    return 0; // Required parameters
+  }
+
+  return RemoveRootPositionsWhere(lpRoot, NULL, NULL, lpfnPredicate,
+      lpfnDeallocFunc);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ResetListRootStats function
+
+void ResetListRootStats(LPLIST_ROOT lpRoot) {
+  if (lpRoot == NULL) {
+    return; // Required parameter
+  }
+
+#ifdef LIST_CORE_ENABLE_STATS
+  ClearListStats(&(lpRoot->stats));
+#else
+  memset(&(lpRoot->stats), 0, sizeof(LIST_STATS));
+#endif //LIST_CORE_ENABLE_STATS
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SortListRoot function
+
+void SortListRoot(LPLIST_ROOT lpRoot, LPSORT_COMPARE_ROUTINE lpfnCompare) {
+  if (lpRoot == NULL || lpRoot->pHead == NULL) {
+    return; // Nothing to do
+  }
+
+  if (lpfnCompare == NULL) {
+    return; // Required parameter
+  }
+
+  LIST_STATS_BEGIN(&(lpRoot->stats));
+
+  SortList(&(lpRoot->pHead), lpfnCompare);
+
+  lpRoot->pTail = GetTailPosition(lpRoot->pHead);
+
+  LIST_STATS_END();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SpliceRootElements function
+
+BOOL SpliceRootElements(LPLIST_ROOT lpDestination, LPPOSITION lpAfter,
+    LPLIST_ROOT lpSource, LPPOSITION lpFirst, LPPOSITION lpLast, int nCount) {
+  if (lpDestination == NULL || lpSource == NULL || lpFirst == NULL
+      || lpLast == NULL) {
+    return FALSE; // Required parameters
+  }
+
+  if (!AreRootAllocatorsCompatible(lpDestination, lpSource)) {
+    return FALSE;
+  }
+
+  /* The compaction's notion of how far it has got depends on the order of
+   the elements, which is about to change; it is abandoned only once nothing
+   can fail any more, so that a failed splice leaves the source as it was. */
+  if (lpDestination == lpSource) {
+    EndRootCompaction(lpSource);
+    MoveRootRange(lpDestination, lpAfter, lpSource, lpFirst, lpLast);
+    return TRUE;
+  }
+
+  LIST_STATS_BEGIN(&(lpDestination->stats));
+
+  // Index the range in the destination first, since that is what can fail
+  if (nCount < 0 || lpDestination->lpIndex != NULL) {
+    nCount = IndexRootRange(lpDestination, lpFirst, lpLast);
+    if (nCount == ERROR) {
+      fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+      LIST_STATS_END();
+      return FALSE;
+    }
+  }
+
+  if (lpSource->lpIndex != NULL) {
+    for (LPPOSITION lpElement = lpFirst; ; lpElement = lpElement->pNext) {
+      RemoveHashIndexEntry(lpSource->lpIndex, lpElement);
+      if (lpElement == lpLast) {
+        break;
+      }
+    }
+  }
+
+  EndRootCompaction(lpSource);
+  MoveRootRange(lpDestination, lpAfter, lpSource, lpFirst, lpLast);
+
+  lpSource->nCount -= nCount;
+  lpDestination->nCount += nCount;
+
+  LIST_STATS_LENGTH(&(lpDestination->stats), lpDestination->nCount);
+
+  LIST_STATS_END();
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SplitListRoot function
+
+BOOL SplitListRoot(LPLIST_ROOT lpRoot, LPPOSITION lpElement,
+    LPLIST_ROOT lpNewRoot) {
+  if (lpRoot == NULL || lpElement == NULL || lpNewRoot == NULL
+      || lpRoot == lpNewRoot) {
+    return FALSE; // Required parameters
+  }
+
+  if (!AreRootAllocatorsCompatible(lpNewRoot, lpRoot)) {
+    return FALSE;
+  }
+
+  return SpliceRootElements(lpNewRoot, lpNewRoot->pTail, lpRoot, lpElement,
+      lpRoot->pTail, CountRootElementsFrom(lpRoot, lpElement));
+}
+
+//////////////////////////////////////////////////////////////////////////////
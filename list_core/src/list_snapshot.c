@@ -0,0 +1,522 @@
+// list_snapshot.c - Provides the implementation of the functions that save
+// linked lists to snapshot files and load or map them back
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "position.h"
+#include "list_snapshot.h"
+#include "list_traversal.h"
+
+/**
+ * @brief Number of elements that LoadListSnapshot rebuilds before it links
+ * them into the list.
+ */
+#define SNAPSHOT_LOAD_BATCH_SIZE 256
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal types
+
+/**
+ * @brief Buffer through which SaveListSnapshot writes the records of a
+ * snapshot file.
+ */
+typedef struct _tagSNAPSHOT_WRITER {
+  int fd;
+  char* pBuffer;
+  int nBufferSize;            // Always a multiple of LIST_SNAPSHOT_ALIGNMENT
+  int nUsed;
+} SNAPSHOT_WRITER, *LPSNAPSHOT_WRITER;
+
+/**
+ * @brief Read-only mapping of a snapshot file, along with the position of the
+ * next record to be read from it.
+ */
+typedef struct _tagSNAPSHOT_READER {
+  char* pMapping;
+  size_t nMappingSize;
+  size_t nOffset;
+  int nCount;
+} SNAPSHOT_READER, *LPSNAPSHOT_READER;
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AlignSnapshotSize function - Rounds a size up to the next multiple of
+// LIST_SNAPSHOT_ALIGNMENT.
+
+static size_t AlignSnapshotSize(size_t nSize) {
+  return (nSize + LIST_SNAPSHOT_ALIGNMENT - 1)
+      & ~((size_t) LIST_SNAPSHOT_ALIGNMENT - 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CloseSnapshotFile function - Unmaps a snapshot file that was opened by
+// OpenSnapshotFile.
+
+static void CloseSnapshotFile(LPSNAPSHOT_READER lpReader) {
+  if (lpReader->pMapping != NULL) {
+    munmap(lpReader->pMapping, lpReader->nMappingSize);
+  }
+
+  memset(lpReader, 0, sizeof(SNAPSHOT_READER));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FlushSnapshotWriter function - Writes out the contents of the buffer.
+
+static BOOL FlushSnapshotWriter(LPSNAPSHOT_WRITER lpWriter) {
+  int nWritten = 0;
+
+  while (nWritten < lpWriter->nUsed) {
+    ssize_t nResult = write(lpWriter->fd, lpWriter->pBuffer + nWritten,
+        (size_t) (lpWriter->nUsed - nWritten));
+    if (nResult < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return FALSE;
+    }
+    nWritten += (int) nResult;
+  }
+
+  lpWriter->nUsed = 0;
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// LinkSnapshotBatch function - Adds a batch of rebuilt elements to the tail
+// of the list that LoadListSnapshot is building, creating the list if need
+// be.  The data of any elements that could not be added are handed to the
+// dealloc routine, if any.  Returns the number of elements added.
+
+static int LinkSnapshotBatch(LPPPOSITION lppHead, LPPPOSITION lppTail,
+    void** ppvData, int nCount, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  int nAdded = 0;
+
+  if (*lppHead == NULL) {
+    nAdded = CreateListFromArray(lppHead, ppvData, nCount);
+    *lppTail = *lppHead;
+  } else {
+    nAdded = AddElementsFromArray(lppTail, ppvData, nCount);
+  }
+
+  if (lpfnDeallocFunc != NULL) {
+    for (int i = nAdded; i < nCount; i++) {
+      lpfnDeallocFunc(ppvData[i]);
+    }
+  }
+
+  return nAdded;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// OpenSnapshotFile function - Maps a snapshot file into memory and checks its
+// header.
+
+static BOOL OpenSnapshotFile(LPSNAPSHOT_READER lpReader, const char* pszPath) {
+  memset(lpReader, 0, sizeof(SNAPSHOT_READER));
+
+  int fd = open(pszPath, O_RDONLY);
+  if (fd < 0) {
+    return FALSE;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) < 0 || st.st_size < (off_t) sizeof(SNAPSHOT_HEADER)) {
+    close(fd);
+    return FALSE;
+  }
+
+  void* pvMapping = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE,
+      fd, 0);
+  close(fd);  // The mapping keeps the file open
+  if (pvMapping == MAP_FAILED) {
+    return FALSE;
+  }
+
+  lpReader->pMapping = (char*) pvMapping;
+  lpReader->nMappingSize = (size_t) st.st_size;
+  lpReader->nOffset = sizeof(SNAPSHOT_HEADER);
+
+  LPSNAPSHOT_HEADER lpHeader = (LPSNAPSHOT_HEADER) pvMapping;
+  if (lpHeader->nMagic != LIST_SNAPSHOT_MAGIC
+      || lpHeader->nVersion != LIST_SNAPSHOT_VERSION
+      || lpHeader->nCount > INT_MAX) {
+    CloseSnapshotFile(lpReader);
+    return FALSE;
+  }
+
+  lpReader->nCount = (int) lpHeader->nCount;
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ReadSnapshotRecord function - Gets the address and size of the next record
+// of a snapshot file, after checking that it lies within the file.
+
+static BOOL ReadSnapshotRecord(LPSNAPSHOT_READER lpReader,
+    void** ppvRecord, int* pnSize) {
+  size_t nRemaining = lpReader->nMappingSize - lpReader->nOffset;
+  if (nRemaining < sizeof(SNAPSHOT_RECORD_HEADER)) {
+    return FALSE; // Truncated file
+  }
+
+  LPSNAPSHOT_RECORD_HEADER lpRecordHeader =
+      (LPSNAPSHOT_RECORD_HEADER) (lpReader->pMapping + lpReader->nOffset);
+  nRemaining -= sizeof(SNAPSHOT_RECORD_HEADER);
+
+  if (lpRecordHeader->nSize > INT_MAX
+      || AlignSnapshotSize(lpRecordHeader->nSize) > nRemaining) {
+    return FALSE; // Corrupt or truncated file
+  }
+
+  *ppvRecord = (void*) (lpRecordHeader + 1);
+  *pnSize = (int) lpRecordHeader->nSize;
+
+  lpReader->nOffset += sizeof(SNAPSHOT_RECORD_HEADER)
+      + AlignSnapshotSize(lpRecordHeader->nSize);
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// WriteSnapshotRecord function - Serializes the data of an element into the
+// buffer, preceded by its record header, flushing or growing the buffer as
+// needed.
+
+static BOOL WriteSnapshotRecord(LPSNAPSHOT_WRITER lpWriter, void* pvData,
+    LPSERIALIZE_ROUTINE lpfnSerialize) {
+  const int nHeaderSize = (int) sizeof(SNAPSHOT_RECORD_HEADER);
+
+  if (lpWriter->nBufferSize - lpWriter->nUsed < nHeaderSize
+      && !FlushSnapshotWriter(lpWriter)) {
+    return FALSE;
+  }
+
+  int nAvailable = lpWriter->nBufferSize - lpWriter->nUsed - nHeaderSize;
+  int nSize = lpfnSerialize(pvData,
+      lpWriter->pBuffer + lpWriter->nUsed + nHeaderSize, nAvailable);
+  if (nSize < 0) {
+    return FALSE;
+  }
+
+  if (nSize > nAvailable) {
+    // Make room for the record at the start of the buffer, and then have it
+    // serialized again
+    if (!FlushSnapshotWriter(lpWriter)) {
+      return FALSE;
+    }
+
+    if (nSize > lpWriter->nBufferSize - nHeaderSize) {
+      if (nSize > INT_MAX - LIST_SNAPSHOT_ALIGNMENT - nHeaderSize) {
+        return FALSE;
+      }
+
+      int nNewSize = (int) AlignSnapshotSize((size_t) nSize + nHeaderSize);
+      char* pNewBuffer = (char*) realloc(lpWriter->pBuffer,
+          (size_t) nNewSize);
+      if (pNewBuffer == NULL) {
+        return FALSE;
+      }
+
+      lpWriter->pBuffer = pNewBuffer;
+      lpWriter->nBufferSize = nNewSize;
+    }
+
+    nAvailable = lpWriter->nBufferSize - nHeaderSize;
+    nSize = lpfnSerialize(pvData, lpWriter->pBuffer + nHeaderSize,
+        nAvailable);
+    if (nSize < 0 || nSize > nAvailable) {
+      return FALSE;
+    }
+  }
+
+  LPSNAPSHOT_RECORD_HEADER lpRecordHeader =
+      (LPSNAPSHOT_RECORD_HEADER) (lpWriter->pBuffer + lpWriter->nUsed);
+  lpRecordHeader->nSize = (uint32_t) nSize;
+  lpRecordHeader->nReserved = 0;
+
+  // The buffer size and the amount used are both multiples of the alignment,
+  // so the padding always fits
+  int nPaddedSize = (int) AlignSnapshotSize((size_t) nSize);
+  memset(lpWriter->pBuffer + lpWriter->nUsed + nHeaderSize + nSize, 0,
+      (size_t) (nPaddedSize - nSize));
+
+  lpWriter->nUsed += nHeaderSize + nPaddedSize;
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// GetListSnapshotCount function
+
+int GetListSnapshotCount(LPLIST_SNAPSHOT lpSnapshot) {
+  if (lpSnapshot == NULL) {
+    return 0;
+  }
+
+  return lpSnapshot->nCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetListSnapshotHead function
+
+LPPOSITION GetListSnapshotHead(LPLIST_SNAPSHOT lpSnapshot) {
+  if (lpSnapshot == NULL || lpSnapshot->nCount == 0) {
+    return NULL;
+  }
+
+  return &(lpSnapshot->aPositions[0]);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// LoadListSnapshot function
+
+int LoadListSnapshot(LPPPOSITION lppNewHead, const char* pszPath,
+    LPDESERIALIZE_ROUTINE lpfnDeserialize, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppNewHead == NULL) {
+    return ERROR;
+  }
+
+  *lppNewHead = NULL;
+
+  if (pszPath == NULL || lpfnDeserialize == NULL) {
+    return ERROR; // Required parameters
+  }
+
+  SNAPSHOT_READER reader;
+  if (!OpenSnapshotFile(&reader, pszPath)) {
+    return ERROR;
+  }
+
+  madvise(reader.pMapping, reader.nMappingSize, MADV_SEQUENTIAL);
+
+  void* apvBatch[SNAPSHOT_LOAD_BATCH_SIZE];
+  int nBatchCount = 0;
+  int nLoaded = 0;
+  BOOL bSucceeded = TRUE;
+  LPPOSITION lpTail = NULL;
+
+  for (int i = 0; i < reader.nCount; i++) {
+    void* pvRecord = NULL;
+    int nSize = 0;
+
+    if (!ReadSnapshotRecord(&reader, &pvRecord, &nSize)) {
+      bSucceeded = FALSE;
+      break;
+    }
+
+    apvBatch[nBatchCount] = lpfnDeserialize(pvRecord, nSize);
+    if (apvBatch[nBatchCount] == NULL) {
+      bSucceeded = FALSE;
+      break;
+    }
+
+    if (++nBatchCount == SNAPSHOT_LOAD_BATCH_SIZE) {
+      int nAdded = LinkSnapshotBatch(lppNewHead, &lpTail, apvBatch,
+          nBatchCount, lpfnDeallocFunc);
+      nLoaded += nAdded;
+      nBatchCount = 0;
+
+      if (nAdded < SNAPSHOT_LOAD_BATCH_SIZE) {
+        bSucceeded = FALSE;
+        break;
+      }
+    }
+  }
+
+  // Link whatever is left over, even after a failure, so that the
+  // application can deallocate it along with the rest of the list
+  if (nBatchCount > 0) {
+    int nAdded = LinkSnapshotBatch(lppNewHead, &lpTail, apvBatch,
+        nBatchCount, lpfnDeallocFunc);
+    nLoaded += nAdded;
+
+    if (nAdded < nBatchCount) {
+      bSucceeded = FALSE;
+    }
+  }
+
+  CloseSnapshotFile(&reader);
+
+  return bSucceeded ? nLoaded : ERROR;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// MapListSnapshot function
+
+void MapListSnapshot(LPPLIST_SNAPSHOT lppSnapshot, const char* pszPath) {
+  if (lppSnapshot == NULL) {
+    return;
+  }
+
+  *lppSnapshot = NULL;
+
+  if (pszPath == NULL) {
+    return; // Required parameter
+  }
+
+  SNAPSHOT_READER reader;
+  if (!OpenSnapshotFile(&reader, pszPath)) {
+    return;
+  }
+
+  // No file of this size could hold the records the header claims it does
+  if ((size_t) reader.nCount > reader.nMappingSize
+      / sizeof(SNAPSHOT_RECORD_HEADER)) {
+    CloseSnapshotFile(&reader);
+    return;
+  }
+
+  LPLIST_SNAPSHOT lpSnapshot = (LPLIST_SNAPSHOT) malloc(sizeof(LIST_SNAPSHOT)
+      + (size_t) reader.nCount * sizeof(POSITION));
+  if (lpSnapshot == NULL) {
+    fprintf(stderr, FAILED_ALLOC_SNAPSHOT);
+    CloseSnapshotFile(&reader);
+    return;
+  }
+
+  for (int i = 0; i < reader.nCount; i++) {
+    LPPOSITION lpPosition = &(lpSnapshot->aPositions[i]);
+    int nSize = 0;
+
+    if (!ReadSnapshotRecord(&reader, &(lpPosition->pvData), &nSize)) {
+      free(lpSnapshot);
+      CloseSnapshotFile(&reader);
+      return;
+    }
+
+    lpPosition->pPrev = i > 0 ? lpPosition - 1 : NULL;
+    lpPosition->pNext = i + 1 < reader.nCount ? lpPosition + 1 : NULL;
+  }
+
+  lpSnapshot->pvMapping = reader.pMapping;
+  lpSnapshot->nMappingSize = reader.nMappingSize;
+  lpSnapshot->nCount = reader.nCount;
+
+  *lppSnapshot = lpSnapshot;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SaveListSnapshot function
+
+int SaveListSnapshot(LPPOSITION lpElement, const char* pszPath,
+    LPSERIALIZE_ROUTINE lpfnSerialize) {
+  if (pszPath == NULL || lpfnSerialize == NULL) {
+    return ERROR; // Required parameters
+  }
+
+  size_t nPathLength = strlen(pszPath);
+  char* pszTempPath = (char*) malloc(nPathLength + sizeof(".tmp"));
+  if (pszTempPath == NULL) {
+    return ERROR;
+  }
+  memcpy(pszTempPath, pszPath, nPathLength);
+  memcpy(pszTempPath + nPathLength, ".tmp", sizeof(".tmp"));
+
+  SNAPSHOT_WRITER writer;
+  writer.nBufferSize = LIST_SNAPSHOT_BUFFER_SIZE;
+  writer.nUsed = 0;
+  writer.pBuffer = (char*) malloc((size_t) writer.nBufferSize);
+  writer.fd = open(pszTempPath, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (writer.pBuffer == NULL || writer.fd < 0) {
+    if (writer.fd >= 0) {
+      close(writer.fd);
+      unlink(pszTempPath);
+    }
+    free(writer.pBuffer);
+    free(pszTempPath);
+    return ERROR;
+  }
+
+  // The count is not known until the list has been walked, so the header is
+  // written again once it is
+  SNAPSHOT_HEADER header;
+  header.nMagic = LIST_SNAPSHOT_MAGIC;
+  header.nVersion = LIST_SNAPSHOT_VERSION;
+  header.nCount = 0;
+  header.nReserved = 0;
+
+  memcpy(writer.pBuffer, &header, sizeof(SNAPSHOT_HEADER));
+  writer.nUsed = (int) sizeof(SNAPSHOT_HEADER);
+
+  BOOL bSucceeded = TRUE;
+  int nWritten = 0;
+
+  if (lpElement != NULL) {
+    MoveToHeadPosition(&lpElement);
+
+    TRAVERSAL_CURSOR cursor;
+    BeginTraversal(&cursor, lpElement, TRUE);
+    while ((lpElement = AdvanceTraversal(&cursor)) != NULL) {
+      if (nWritten == INT_MAX
+          || !WriteSnapshotRecord(&writer, lpElement->pvData, lpfnSerialize)) {
+        bSucceeded = FALSE;
+        break;
+      }
+      nWritten++;
+    }
+  }
+
+  if (bSucceeded) {
+    header.nCount = (uint32_t) nWritten;
+    bSucceeded = FlushSnapshotWriter(&writer)
+        && pwrite(writer.fd, &header, sizeof(SNAPSHOT_HEADER), 0)
+            == (ssize_t) sizeof(SNAPSHOT_HEADER)
+        && fsync(writer.fd) == 0;
+  }
+
+  if (close(writer.fd) < 0) {
+    bSucceeded = FALSE;
+  }
+
+  if (bSucceeded && rename(pszTempPath, pszPath) < 0) {
+    bSucceeded = FALSE;
+  }
+
+  if (!bSucceeded) {
+    unlink(pszTempPath);
+  }
+
+  free(writer.pBuffer);
+  free(pszTempPath);
+
+  return bSucceeded ? nWritten : ERROR;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// UnmapListSnapshot function
+
+void UnmapListSnapshot(LPPLIST_SNAPSHOT lppSnapshot) {
+  if (lppSnapshot == NULL || *lppSnapshot == NULL) {
+    return; // Required parameter
+  }
+
+  munmap((*lppSnapshot)->pvMapping, (*lppSnapshot)->nMappingSize);
+
+  free(*lppSnapshot);
+  *lppSnapshot = NULL;
+}
@@ -0,0 +1,98 @@
+// list_stats.c - Provides the implementation of the functions that report the
+// statistics kept by the library
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "list_stats.h"
+#include "list_stats_internal.h"
+
+#ifdef LIST_CORE_ENABLE_STATS
+
+LIST_STATS g_listStats;
+
+__thread LPLIST_STATS g_lpListStatsTarget = NULL;
+
+__thread LIST_STATS g_pendingListStats;
+
+__thread int g_nListStatsScopes = 0;
+
+#endif //LIST_CORE_ENABLE_STATS
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AreListStatsEnabled function
+
+BOOL AreListStatsEnabled(void) {
+#ifdef LIST_CORE_ENABLE_STATS
+  return TRUE;
+#else
+  return FALSE;
+#endif //LIST_CORE_ENABLE_STATS
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DumpListStats function
+
+void DumpListStats(FILE* fp, LPLIST_STATS lpStats) {
+  if (fp == NULL) {
+    return; // Required parameter
+  }
+
+  LIST_STATS stats;
+  if (lpStats == NULL) {
+    GetListStats(&stats);
+    lpStats = &stats;
+  }
+
+  fprintf(fp, "list_core statistics%s:\n",
+      AreListStatsEnabled() ? "" : " (not compiled in)");
+  fprintf(fp, "  nodes traversed: %ld\n", lpStats->nNodesTraversed);
+  fprintf(fp, "  head seeks:      %ld\n", lpStats->nHeadSeeks);
+  fprintf(fp, "  allocations:     %ld\n", lpStats->nAllocations);
+  fprintf(fp, "  frees:           %ld\n", lpStats->nFrees);
+  fprintf(fp, "  comparisons:     %ld\n", lpStats->nComparisons);
+  fprintf(fp, "  max length:      %ld\n", lpStats->nMaxLength);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetListStats function
+
+void GetListStats(LPLIST_STATS lpStats) {
+  if (lpStats == NULL) {
+    return; // Required parameter
+  }
+
+  memset(lpStats, 0, sizeof(LIST_STATS));
+
+#ifdef LIST_CORE_ENABLE_STATS
+  CopyListStats(lpStats, &g_listStats);
+#endif //LIST_CORE_ENABLE_STATS
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ResetListStats function
+
+void ResetListStats(void) {
+#ifdef LIST_CORE_ENABLE_STATS
+  ClearListStats(&g_listStats);
+#endif //LIST_CORE_ENABLE_STATS
+}
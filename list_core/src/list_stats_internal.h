@@ -0,0 +1,222 @@
+// list_stats_internal.h - Internal macros through which the library updates
+// its statistics; they expand to nothing unless LIST_CORE_ENABLE_STATS is
+// defined
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __LIST_STATS_INTERNAL_H__
+#define __LIST_STATS_INTERNAL_H__
+
+#include "list_stats.h"
+
+#ifdef LIST_CORE_ENABLE_STATS
+
+/**
+ * @brief Process-wide statistics.  Updated with relaxed atomic operations,
+ * since the library may be used from several threads at once.
+ */
+extern LIST_STATS g_listStats;
+
+/**
+ * @brief Statistics of the list, if any, on whose behalf the calling thread
+ * is currently working; see LIST_STATS_BEGIN.
+ */
+extern __thread LPLIST_STATS g_lpListStatsTarget;
+
+/**
+ * @brief Counts that the calling thread has accumulated since it last
+ * published them; see LIST_STATS_COUNT.  Only the additive counters are used.
+ */
+extern __thread LIST_STATS g_pendingListStats;
+
+/**
+ * @brief Number of LIST_STATS_BEGIN scopes that the calling thread is in.
+ */
+extern __thread int g_nListStatsScopes;
+
+/**
+ * @brief Raises the counter at the specified address to nValue if nValue is
+ * greater.
+ */
+static inline void RaiseListStatsCounter(long* pnCounter, long nValue) {
+  long nCurrent = __atomic_load_n(pnCounter, __ATOMIC_RELAXED);
+  while (nValue > nCurrent && !__atomic_compare_exchange_n(pnCounter,
+      &nCurrent, nValue, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    // nCurrent has been reloaded; try again
+  }
+}
+
+/**
+ * @brief Raises the process-wide maximum list length, and that of the
+ * specified list, if any, to nLength if it is longer.
+ */
+static inline void UpdateListStatsMaxLength(LPLIST_STATS lpStats,
+    long nLength) {
+  RaiseListStatsCounter(&(g_listStats.nMaxLength), nLength);
+
+  if (lpStats != NULL) {
+    RaiseListStatsCounter(&(lpStats->nMaxLength), nLength);
+  }
+}
+
+/**
+ * @brief Copies a set of statistics that other threads may be updating.
+ */
+static inline void CopyListStats(LPLIST_STATS lpDest, LPLIST_STATS lpSource) {
+  lpDest->nNodesTraversed = __atomic_load_n(&(lpSource->nNodesTraversed),
+      __ATOMIC_RELAXED);
+  lpDest->nHeadSeeks = __atomic_load_n(&(lpSource->nHeadSeeks),
+      __ATOMIC_RELAXED);
+  lpDest->nAllocations = __atomic_load_n(&(lpSource->nAllocations),
+      __ATOMIC_RELAXED);
+  lpDest->nFrees = __atomic_load_n(&(lpSource->nFrees), __ATOMIC_RELAXED);
+  lpDest->nComparisons = __atomic_load_n(&(lpSource->nComparisons),
+      __ATOMIC_RELAXED);
+  lpDest->nMaxLength = __atomic_load_n(&(lpSource->nMaxLength),
+      __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Resets a set of statistics that other threads may be updating.
+ */
+static inline void ClearListStats(LPLIST_STATS lpStats) {
+  __atomic_store_n(&(lpStats->nNodesTraversed), 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&(lpStats->nHeadSeeks), 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&(lpStats->nAllocations), 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&(lpStats->nFrees), 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&(lpStats->nComparisons), 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&(lpStats->nMaxLength), 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Adds a count that the calling thread has accumulated to the
+ * corresponding process-wide counter, and to that of the target, if any, and
+ * resets it.
+ */
+static inline void PublishListStatsCounter(long* pnPending, long* pnGlobal,
+    long* pnTarget) {
+  if (*pnPending == 0) {
+    return; // Nothing to do
+  }
+
+  __atomic_fetch_add(pnGlobal, *pnPending, __ATOMIC_RELAXED);
+  if (pnTarget != NULL) {
+    __atomic_fetch_add(pnTarget, *pnPending, __ATOMIC_RELAXED);
+  }
+
+  *pnPending = 0;
+}
+
+/**
+ * @brief Adds the counts that the calling thread has accumulated to the
+ * process-wide statistics and to those of its current target, if any, and
+ * starts accumulating afresh.  Several threads may be working on behalf of
+ * the same list at once, e.g., readers of a CONCURRENT_LIST stripe that hold
+ * a shared lock, so the target's counters are updated atomically as well.
+ */
+static inline void PublishListStats(void) {
+  LPLIST_STATS lpPending = &g_pendingListStats;
+  LPLIST_STATS lpTarget = g_lpListStatsTarget;
+
+  PublishListStatsCounter(&(lpPending->nNodesTraversed),
+      &(g_listStats.nNodesTraversed),
+      lpTarget != NULL ? &(lpTarget->nNodesTraversed) : NULL);
+  PublishListStatsCounter(&(lpPending->nHeadSeeks),
+      &(g_listStats.nHeadSeeks),
+      lpTarget != NULL ? &(lpTarget->nHeadSeeks) : NULL);
+  PublishListStatsCounter(&(lpPending->nAllocations),
+      &(g_listStats.nAllocations),
+      lpTarget != NULL ? &(lpTarget->nAllocations) : NULL);
+  PublishListStatsCounter(&(lpPending->nFrees), &(g_listStats.nFrees),
+      lpTarget != NULL ? &(lpTarget->nFrees) : NULL);
+  PublishListStatsCounter(&(lpPending->nComparisons),
+      &(g_listStats.nComparisons),
+      lpTarget != NULL ? &(lpTarget->nComparisons) : NULL);
+}
+
+/**
+ * @brief Enters a LIST_STATS_BEGIN scope; returns the previous target.  What
+ * has been counted so far is published first, against the previous target.
+ */
+static inline LPLIST_STATS BeginListStats(LPLIST_STATS lpStats) {
+  LPLIST_STATS lpSavedTarget = g_lpListStatsTarget;
+
+  PublishListStats();
+
+  g_nListStatsScopes++;
+  g_lpListStatsTarget = lpStats;
+
+  return lpSavedTarget;
+}
+
+/**
+ * @brief Leaves a LIST_STATS_BEGIN scope, publishing what has been counted in
+ * it, and restores the previous target.
+ */
+static inline void EndListStats(LPLIST_STATS lpSavedTarget) {
+  PublishListStats();
+
+  g_nListStatsScopes--;
+  g_lpListStatsTarget = lpSavedTarget;
+}
+
+/**
+ * @brief Adds n to the named counter.  Within a LIST_STATS_BEGIN scope, the
+ * count is accumulated in the calling thread's own statistics, and published
+ * once, when the scope ends, so that threads walking lists do not contend on
+ * the shared counters at every node; outside of one, it is added to the
+ * process-wide statistics at once.
+ */
+#define LIST_STATS_COUNT(field, n) \
+  do { \
+    if (g_nListStatsScopes > 0) { \
+      g_pendingListStats.field += (long) (n); \
+    } else { \
+      __atomic_fetch_add(&(g_listStats.field), (long) (n), \
+          __ATOMIC_RELAXED); \
+    } \
+  } while (0)
+
+/**
+ * @brief Records that a list has reached the specified length.
+ */
+#define LIST_STATS_LENGTH(lpStats, nLength) \
+  UpdateListStatsMaxLength((lpStats), (long) (nLength))
+
+/**
+ * @brief Makes the specified statistics the current target of the calling
+ * thread until the matching LIST_STATS_END, which must be reached in the same
+ * scope.  Used by the functions that work on a LIST_ROOT, so that the work
+ * done by the list_core.h functions they call is counted against the root.
+ * What is counted within the scope is published when it ends.
+ */
+#define LIST_STATS_BEGIN(lpStats) \
+  LPLIST_STATS lpSavedStatsTarget = BeginListStats(lpStats)
+
+#define LIST_STATS_END() \
+  EndListStats(lpSavedStatsTarget)
+
+#else
+
+#define LIST_STATS_COUNT(field, n) ((void) 0)
+#define LIST_STATS_LENGTH(lpStats, nLength) ((void) 0)
+#define LIST_STATS_BEGIN(lpStats) ((void) 0)
+#define LIST_STATS_END() ((void) 0)
+
+#endif //LIST_CORE_ENABLE_STATS
+
+#endif //__LIST_STATS_INTERNAL_H__
@@ -0,0 +1,319 @@
+// list_stream.c - Provides the implementation of the functions that build
+// linked lists from records read from a file descriptor
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "list_root.h"
+#include "list_stream.h"
+
+/**
+ * @brief Size, in bytes, of the length that precedes each record of a
+ * length-prefixed stream.
+ */
+#define STREAM_LENGTH_PREFIX_SIZE 4
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal types
+
+/**
+ * @brief Defines the format of a routine that adds a batch of parsed records
+ * to whichever kind of list is being built, and returns the number added.
+ */
+typedef int (*LPSTREAM_APPEND_ROUTINE)(void* pvTarget, void** ppvData,
+    int nCount);
+
+/**
+ * @brief Parsed records that are waiting to be added to the list.
+ */
+typedef struct _tagSTREAM_BATCH {
+  void* apvData[LIST_STREAM_BATCH_SIZE];
+  int nCount;
+  int nAdded;                 // Added to the list so far, over all batches
+  LPSTREAM_APPEND_ROUTINE lpfnAppend;
+  void* pvTarget;
+  LPDEALLOC_ROUTINE lpfnDeallocFunc;
+} STREAM_BATCH, *LPSTREAM_BATCH;
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AppendToList function - Adds a batch to a list that is referred to by its
+// current element pointer.
+
+static int AppendToList(void* pvTarget, void** ppvData, int nCount) {
+  return AddElementsFromArray((LPPPOSITION) pvTarget, ppvData, nCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AppendToListRoot function - Adds a batch to a list that is managed by a
+// root.
+
+static int AppendToListRoot(void* pvTarget, void** ppvData, int nCount) {
+  return AddRootElementsFromArray((LPLIST_ROOT) pvTarget, ppvData, nCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindStreamRecord function - Looks for a complete record at the start of the
+// unparsed part of the buffer.  Returns 1 if there is one, along with where
+// its data starts, its size and the number of bytes it takes up in the
+// stream; 0 if more of the stream must be read first; or ERROR if the stream
+// is malformed.  For delimited records, *pnScanned carries over how much of
+// the buffer is already known not to contain the delimiter, so that a long
+// record is not searched again from the start every time more of it is read.
+
+static int FindStreamRecord(LPSTREAM_OPTIONS lpOptions, const char* pData,
+    int nAvailable, BOOL bEndOfStream, int* pnScanned, int* pnOffset,
+    int* pnSize, int* pnConsumed) {
+  if (nAvailable == 0) {
+    return 0; // Nothing to do
+  }
+
+  if (!lpOptions->bLengthPrefixed) {
+    const char* pDelimiter = (const char*) memchr(pData + *pnScanned,
+        lpOptions->chDelimiter, (size_t) (nAvailable - *pnScanned));
+
+    if (pDelimiter == NULL) {
+      *pnScanned = nAvailable;
+      if (nAvailable > lpOptions->nMaxRecordSize) {
+        return ERROR; // Record too long
+      }
+      if (!bEndOfStream) {
+        return 0;
+      }
+    }
+
+    *pnOffset = 0;
+    *pnSize = pDelimiter != NULL ? (int) (pDelimiter - pData) : nAvailable;
+    *pnConsumed = pDelimiter != NULL ? *pnSize + 1 : nAvailable;
+    *pnScanned = 0;
+
+    return *pnSize > lpOptions->nMaxRecordSize ? ERROR : 1;
+  }
+
+  if (nAvailable < STREAM_LENGTH_PREFIX_SIZE) {
+    return bEndOfStream ? ERROR : 0;
+  }
+
+  uint32_t nLength = 0;
+  memcpy(&nLength, pData, STREAM_LENGTH_PREFIX_SIZE);
+  nLength = ntohl(nLength);
+
+  if (nLength > (uint32_t) lpOptions->nMaxRecordSize) {
+    return ERROR; // Record too long, or a corrupt length
+  }
+
+  if ((uint32_t) (nAvailable - STREAM_LENGTH_PREFIX_SIZE) < nLength) {
+    return bEndOfStream ? ERROR : 0;
+  }
+
+  *pnOffset = STREAM_LENGTH_PREFIX_SIZE;
+  *pnSize = (int) nLength;
+  *pnConsumed = STREAM_LENGTH_PREFIX_SIZE + (int) nLength;
+
+  return 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FlushStreamBatch function - Adds the waiting records to the list.  The data
+// of any that could not be added are handed to the dealloc routine, if any.
+// Returns FALSE if not all of them could be added.
+
+static BOOL FlushStreamBatch(LPSTREAM_BATCH lpBatch) {
+  if (lpBatch->nCount == 0) {
+    return TRUE;  // Nothing to do
+  }
+
+  int nAdded = lpBatch->lpfnAppend(lpBatch->pvTarget, lpBatch->apvData,
+      lpBatch->nCount);
+  BOOL bSucceeded = nAdded == lpBatch->nCount;
+
+  if (lpBatch->lpfnDeallocFunc != NULL) {
+    for (int i = nAdded; i < lpBatch->nCount; i++) {
+      lpBatch->lpfnDeallocFunc(lpBatch->apvData[i]);
+    }
+  }
+
+  lpBatch->nAdded += nAdded;
+  lpBatch->nCount = 0;
+
+  return bSucceeded;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ReadStreamRecords function - Reads a stream into a buffer, hands each
+// complete record to the parse routine where it lies, and adds the results to
+// the list in batches.  Returns the number of elements added, or ERROR.
+
+static int ReadStreamRecords(int fd, LPPARSE_ROUTINE lpfnParse,
+    void* pvContext, LPDEALLOC_ROUTINE lpfnDeallocFunc,
+    LPSTREAM_OPTIONS lpOptions, LPSTREAM_APPEND_ROUTINE lpfnAppend,
+    void* pvTarget) {
+  STREAM_OPTIONS options;
+  memset(&options, 0, sizeof(STREAM_OPTIONS));
+  options.chDelimiter = '\n';
+  if (lpOptions != NULL) {
+    options = *lpOptions;
+  }
+  if (options.nBufferSize <= 0) {
+    options.nBufferSize = LIST_STREAM_DEFAULT_BUFFER_SIZE;
+  }
+  if (options.nMaxRecordSize <= 0) {
+    options.nMaxRecordSize = LIST_STREAM_DEFAULT_MAX_RECORD_SIZE;
+  }
+
+  // The buffer never needs to hold more than one record, and its prefix, that
+  // has not been parsed yet
+  int nMaxCapacity = options.nMaxRecordSize
+      > INT_MAX - STREAM_LENGTH_PREFIX_SIZE - 1 ? INT_MAX
+      : options.nMaxRecordSize + STREAM_LENGTH_PREFIX_SIZE + 1;
+
+  int nCapacity = options.nBufferSize;
+  char* pBuffer = (char*) malloc((size_t) nCapacity);
+  if (pBuffer == NULL) {
+    return ERROR;
+  }
+
+  STREAM_BATCH batch;
+  batch.nCount = 0;
+  batch.nAdded = 0;
+  batch.lpfnAppend = lpfnAppend;
+  batch.pvTarget = pvTarget;
+  batch.lpfnDeallocFunc = lpfnDeallocFunc;
+
+  int nStart = 0;             // Start of the data not yet parsed
+  int nEnd = 0;               // End of the data read so far
+  int nScanned = 0;
+  BOOL bEndOfStream = FALSE;
+  BOOL bSucceeded = TRUE;
+
+  while (bSucceeded) {
+    int nOffset = 0;
+    int nSize = 0;
+    int nConsumed = 0;
+    int nResult = 0;
+
+    while ((nResult = FindStreamRecord(&options, pBuffer + nStart,
+        nEnd - nStart, bEndOfStream, &nScanned, &nOffset, &nSize,
+        &nConsumed)) > 0) {
+      void* pvData = lpfnParse(pBuffer + nStart + nOffset, nSize, pvContext);
+      nStart += nConsumed;
+
+      if (pvData == NULL) {
+        continue;   // The parse routine chose to skip the record
+      }
+
+      batch.apvData[batch.nCount++] = pvData;
+      if (batch.nCount == LIST_STREAM_BATCH_SIZE
+          && !FlushStreamBatch(&batch)) {
+        bSucceeded = FALSE;
+        break;
+      }
+    }
+
+    if (!bSucceeded || nResult == ERROR) {
+      bSucceeded = FALSE;
+      break;
+    }
+
+    if (bEndOfStream) {
+      break;
+    }
+
+    // Move the partial record, if any, to the start of the buffer, and grow
+    // the buffer if the record fills it
+    if (nStart > 0) {
+      memmove(pBuffer, pBuffer + nStart, (size_t) (nEnd - nStart));
+      nEnd -= nStart;
+      nStart = 0;
+    }
+
+    if (nEnd == nCapacity) {
+      if (nCapacity >= nMaxCapacity) {
+        bSucceeded = FALSE;
+        break;
+      }
+
+      int nNewCapacity = nCapacity > nMaxCapacity / 2 ? nMaxCapacity
+          : nCapacity * 2;
+      char* pNewBuffer = (char*) realloc(pBuffer, (size_t) nNewCapacity);
+      if (pNewBuffer == NULL) {
+        bSucceeded = FALSE;
+        break;
+      }
+
+      pBuffer = pNewBuffer;
+      nCapacity = nNewCapacity;
+    }
+
+    ssize_t nRead = read(fd, pBuffer + nEnd, (size_t) (nCapacity - nEnd));
+    if (nRead < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      bSucceeded = FALSE;
+    } else if (nRead == 0) {
+      bEndOfStream = TRUE;
+    } else {
+      nEnd += (int) nRead;
+    }
+  }
+
+  // Add whatever was parsed, even after a failure, so that the application
+  // can deallocate it along with the rest of the list
+  if (!FlushStreamBatch(&batch)) {
+    bSucceeded = FALSE;
+  }
+
+  free(pBuffer);
+
+  return bSucceeded ? batch.nAdded : ERROR;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AddElementsFromStream function
+
+int AddElementsFromStream(LPPPOSITION lppElement, int fd,
+    LPPARSE_ROUTINE lpfnParse, void* pvContext,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc, LPSTREAM_OPTIONS lpOptions) {
+  if (lppElement == NULL || fd < 0 || lpfnParse == NULL) {
+    return ERROR; // Required parameters
+  }
+
+  return ReadStreamRecords(fd, lpfnParse, pvContext, lpfnDeallocFunc,
+      lpOptions, AppendToList, lppElement);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AddRootElementsFromStream function
+
+int AddRootElementsFromStream(LPLIST_ROOT lpRoot, int fd,
+    LPPARSE_ROUTINE lpfnParse, void* pvContext,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc, LPSTREAM_OPTIONS lpOptions) {
+  if (lpRoot == NULL || fd < 0 || lpfnParse == NULL) {
+    return ERROR; // Required parameters
+  }
+
+  return ReadStreamRecords(fd, lpfnParse, pvContext, lpfnDeallocFunc,
+      lpOptions, AppendToListRoot, lpRoot);
+}
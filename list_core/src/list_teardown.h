@@ -0,0 +1,54 @@
+// list_teardown.h - Internal functions that tear down whole chains of nodes,
+// either on the calling thread or on a background thread
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __LIST_TEARDOWN_H__
+#define __LIST_TEARDOWN_H__
+
+#include "list_core.h"
+#include "position_pool.h"
+
+/**
+ * @name DestroyPositions
+ * @brief Deallocates the data of each node of a chain that has already been
+ * detached from any list, and then the node itself, in a single pass from
+ * lpFirst onwards.
+ * @param lpFirst Address of the first node of the chain, or NULL.
+ * @param lpfnDeallocFunc Address of the routine that deallocates the data.
+ * @param lpPool Address of the private pool from which all of the nodes were
+ * allocated, or NULL if they were allocated from the heap.  A pool is
+ * destroyed, with all of its slabs, once the data have been deallocated.
+ * @return Number of nodes in the chain.
+ */
+int DestroyPositions(LPPOSITION lpFirst, LPDEALLOC_ROUTINE lpfnDeallocFunc,
+    LPPOSITION_POOL lpPool);
+
+/**
+ * @name StartAsyncClear
+ * @brief Hands a detached chain of nodes to a background thread, which
+ * passes it to DestroyPositions.
+ * @param lpFirst Address of the first node of the chain.
+ * @param lpfnDeallocFunc Address of the routine that deallocates the data.
+ * @param lpPool As for DestroyPositions.
+ * @remarks If the thread cannot be started, the chain is destroyed on the
+ * calling thread instead.
+ */
+void StartAsyncClear(LPPOSITION lpFirst, LPDEALLOC_ROUTINE lpfnDeallocFunc,
+    LPPOSITION_POOL lpPool);
+
+#endif //__LIST_TEARDOWN_H__
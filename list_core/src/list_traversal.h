@@ -0,0 +1,165 @@
+// list_traversal.h - Internal iteration engine shared by the functions that
+// walk a linked list from one element to the next
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __LIST_TRAVERSAL_H__
+#define __LIST_TRAVERSAL_H__
+
+#include "position.h"
+#include "list_stats_internal.h"
+
+/**
+ * @brief Number of elements ahead of the current one at which a traversal
+ * issues software prefetches.  Define as 0 to build without prefetching.
+ */
+#ifndef LIST_CORE_PREFETCH_DISTANCE
+#define LIST_CORE_PREFETCH_DISTANCE 4
+#endif //LIST_CORE_PREFETCH_DISTANCE
+
+/**
+ * @brief State of a traversal of a linked list.
+ *
+ * Walking a list is a chain of dependent loads, each of which stalls if the
+ * next node is not in cache, so the cursor prefetches the nodes that the
+ * traversal is about to reach and, optionally, the data they refer to.
+ *
+ * A traversal started with BeginTraversal may be used to run application code
+ * for each element, since it keeps no pointer past the element that follows
+ * the current one: that code may remove any element but the current one, as
+ * it always could.  As each element is reached, the cursor prefetches the
+ * data of the next element, and the node after that one.
+ *
+ * A traversal started with BeginReadAheadTraversal goes further.  Alongside
+ * the current element, the cursor keeps a second pointer
+ * LIST_CORE_PREFETCH_DISTANCE elements further on, and as the traversal
+ * advances, it prefetches the node after that one and, optionally, its data.
+ * By the time the traversal reaches those nodes, they have had several
+ * elements' worth of work in which to arrive.  Since the cursor reads ahead,
+ * such a traversal may only be used by loops that run no application code,
+ * or only callbacks that are documented not to remove elements, i.e., the
+ * comparison, predicate and summation routines.
+ */
+typedef struct _tagTRAVERSAL_CURSOR {
+  LPPOSITION lpCurrent;       // Element most recently returned, if any
+  LPPOSITION lpFirst;         // Element to return first
+  LPPOSITION lpAhead;         // Element being read ahead of lpCurrent
+  BOOL bPrefetchData;         // Whether to prefetch the elements' data too
+  BOOL bReadAhead;            // Whether lpAhead is in use
+} TRAVERSAL_CURSOR, *LPTRAVERSAL_CURSOR;
+
+/**
+ * @name BeginReadAheadTraversal
+ * @brief Sets up a cursor to walk a list, starting from the specified
+ * element, reading LIST_CORE_PREFETCH_DISTANCE elements ahead.
+ * @param lpCursor Address of the cursor.
+ * @param lpStart Address of the first element to visit, or NULL.
+ * @param bPrefetchData TRUE if the elements' data will be dereferenced, and
+ * so should be prefetched along with the nodes.
+ * @remarks Elements that follow the current one must not be removed from the
+ * list during the traversal; see TRAVERSAL_CURSOR.
+ */
+static inline void BeginReadAheadTraversal(LPTRAVERSAL_CURSOR lpCursor,
+    LPPOSITION lpStart, BOOL bPrefetchData) {
+  lpCursor->lpCurrent = NULL;
+  lpCursor->lpFirst = lpStart;
+  lpCursor->lpAhead = lpStart;
+  lpCursor->bPrefetchData = bPrefetchData;
+  lpCursor->bReadAhead = LIST_CORE_PREFETCH_DISTANCE > 0;
+
+#if LIST_CORE_PREFETCH_DISTANCE > 0
+  for (int i = 0; i < LIST_CORE_PREFETCH_DISTANCE
+      && lpCursor->lpAhead != NULL; i++) {
+    if (bPrefetchData) {
+      __builtin_prefetch(lpCursor->lpAhead->pvData);
+    }
+    lpCursor->lpAhead = lpCursor->lpAhead->pNext;
+  }
+#endif //LIST_CORE_PREFETCH_DISTANCE
+}
+
+/**
+ * @name BeginTraversal
+ * @brief Sets up a cursor to walk a list, starting from the specified
+ * element, in a way that allows the code run for each element to remove
+ * other elements.
+ * @param lpCursor Address of the cursor.
+ * @param lpStart Address of the first element to visit, or NULL.
+ * @param bPrefetchData TRUE if the elements' data will be dereferenced, and
+ * so should be prefetched along with the nodes.
+ */
+static inline void BeginTraversal(LPTRAVERSAL_CURSOR lpCursor,
+    LPPOSITION lpStart, BOOL bPrefetchData) {
+  lpCursor->lpCurrent = NULL;
+  lpCursor->lpFirst = lpStart;
+  lpCursor->lpAhead = NULL;
+  lpCursor->bPrefetchData = bPrefetchData;
+  lpCursor->bReadAhead = FALSE;
+}
+
+/**
+ * @name AdvanceTraversal
+ * @brief Moves the cursor on to the next element.
+ * @param lpCursor Address of the cursor.
+ * @return Address of the element to visit, or NULL once the tail of the list
+ * has been passed.
+ * @remarks The link to the next element is followed only when this function
+ * is next called, so the code run for an element may still insert elements
+ * right after it.
+ */
+static inline LPPOSITION AdvanceTraversal(LPTRAVERSAL_CURSOR lpCursor) {
+  if (lpCursor->lpCurrent != NULL) {
+    lpCursor->lpCurrent = lpCursor->lpCurrent->pNext;
+  } else if (lpCursor->lpFirst != NULL) {
+    lpCursor->lpCurrent = lpCursor->lpFirst;
+    lpCursor->lpFirst = NULL;
+  }
+
+#if LIST_CORE_PREFETCH_DISTANCE > 0
+  if (lpCursor->bReadAhead) {
+    LPPOSITION lpAhead = lpCursor->lpAhead;
+    if (lpAhead != NULL) {
+      if (lpCursor->bPrefetchData) {
+        __builtin_prefetch(lpAhead->pvData);
+      }
+      lpAhead = lpAhead->pNext;
+      if (lpAhead != NULL) {
+        __builtin_prefetch(lpAhead);
+      }
+      lpCursor->lpAhead = lpAhead;
+    }
+  } else if (lpCursor->lpCurrent != NULL
+      && lpCursor->lpCurrent->pNext != NULL) {
+    /* The next element is still in the list at this point, before the code
+     for the current one has run, so it is safe to read; the node after it
+     is only prefetched, which never faults, even if it is removed. */
+    LPPOSITION lpNext = lpCursor->lpCurrent->pNext;
+    if (lpCursor->bPrefetchData) {
+      __builtin_prefetch(lpNext->pvData);
+    }
+    __builtin_prefetch(lpNext->pNext);
+  }
+#endif //LIST_CORE_PREFETCH_DISTANCE
+
+  if (lpCursor->lpCurrent != NULL) {
+    LIST_STATS_COUNT(nNodesTraversed, 1);
+  }
+
+  return lpCursor->lpCurrent;
+}
+
+#endif //__LIST_TRAVERSAL_H__
@@ -0,0 +1,369 @@
+// lockfree_queue.c - Implementations of functions that provide the
+// functionality of a lock-free, multi-producer, multi-consumer FIFO queue
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "lockfree_queue.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AcquireHazardRecord function - Claims an inactive hazard-pointer record for
+// the calling thread, or adds a new one to the queue if all are in use.
+
+static LPHAZARD_RECORD AcquireHazardRecord(LPLOCKFREE_QUEUE lpQueue) {
+  LPHAZARD_RECORD lpRecord = __atomic_load_n(&(lpQueue->pHazardRecords),
+      __ATOMIC_ACQUIRE);
+
+  for (; lpRecord != NULL; lpRecord = lpRecord->pNext) {
+    int bExpected = FALSE;
+    if (__atomic_load_n(&(lpRecord->bActive), __ATOMIC_RELAXED) == FALSE
+        && __atomic_compare_exchange_n(&(lpRecord->bActive), &bExpected,
+            TRUE, FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+      return lpRecord;
+    }
+  }
+
+  lpRecord = (LPHAZARD_RECORD) calloc(1, sizeof(HAZARD_RECORD));
+  if (lpRecord == NULL) {
+    return NULL;
+  }
+
+  lpRecord->bActive = TRUE;
+
+  LPHAZARD_RECORD lpHead = __atomic_load_n(&(lpQueue->pHazardRecords),
+      __ATOMIC_RELAXED);
+  do {
+    lpRecord->pNext = lpHead;
+  } while (!__atomic_compare_exchange_n(&(lpQueue->pHazardRecords), &lpHead,
+      lpRecord, TRUE, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+  return lpRecord;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// IsHazardous function - Determines whether any thread has published the
+// specified node as one of its hazard pointers.
+
+static BOOL IsHazardous(LPLOCKFREE_QUEUE lpQueue, LPQUEUE_NODE lpNode) {
+  LPHAZARD_RECORD lpRecord = __atomic_load_n(&(lpQueue->pHazardRecords),
+      __ATOMIC_ACQUIRE);
+
+  for (; lpRecord != NULL; lpRecord = lpRecord->pNext) {
+    for (int i = 0; i < 2; i++) {
+      if (__atomic_load_n(&(lpRecord->apHazards[i]), __ATOMIC_SEQ_CST)
+          == lpNode) {
+        return TRUE;
+      }
+    }
+  }
+
+  return FALSE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ScanRetiredNodes function - Frees each of the record's retired nodes that
+// no thread currently refers to through a hazard pointer.
+
+static void ScanRetiredNodes(LPLOCKFREE_QUEUE lpQueue,
+    LPHAZARD_RECORD lpRecord) {
+  int nKept = 0;
+
+  for (int i = 0; i < lpRecord->nRetiredCount; i++) {
+    LPQUEUE_NODE lpNode = lpRecord->ppRetired[i];
+    if (IsHazardous(lpQueue, lpNode)) {
+      lpRecord->ppRetired[nKept++] = lpNode;
+    } else {
+      free(lpNode);
+    }
+  }
+
+  lpRecord->nRetiredCount = nKept;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ReleaseHazardRecord function - Clears the record's hazard pointers and
+// gives the record up, so that another thread may claim it.
+
+static void ReleaseHazardRecord(LPHAZARD_RECORD lpRecord) {
+  __atomic_store_n(&(lpRecord->apHazards[0]), NULL, __ATOMIC_RELEASE);
+  __atomic_store_n(&(lpRecord->apHazards[1]), NULL, __ATOMIC_RELEASE);
+  __atomic_store_n(&(lpRecord->bActive), FALSE, __ATOMIC_RELEASE);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RetireNode function - Defers the freeing of a node that has been unlinked
+// from the queue until no thread refers to it any longer.
+
+static void RetireNode(LPLOCKFREE_QUEUE lpQueue, LPHAZARD_RECORD lpRecord,
+    LPQUEUE_NODE lpNode) {
+  if (lpRecord->nRetiredCount == lpRecord->nRetiredCapacity) {
+    int nCapacity = lpRecord->nRetiredCapacity > 0
+        ? 2 * lpRecord->nRetiredCapacity
+        : LOCKFREE_QUEUE_RETIRE_THRESHOLD;
+    LPQUEUE_NODE* ppGrown = (LPQUEUE_NODE*) realloc(lpRecord->ppRetired,
+        nCapacity * sizeof(LPQUEUE_NODE));
+    if (ppGrown == NULL) {
+      /* Without room to defer it, the node can only be leaked safely. */
+      ScanRetiredNodes(lpQueue, lpRecord);
+      return;
+    }
+    lpRecord->ppRetired = ppGrown;
+    lpRecord->nRetiredCapacity = nCapacity;
+  }
+
+  lpRecord->ppRetired[lpRecord->nRetiredCount++] = lpNode;
+
+  if (lpRecord->nRetiredCount >= LOCKFREE_QUEUE_RETIRE_THRESHOLD) {
+    ScanRetiredNodes(lpQueue, lpRecord);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateLockFreeQueue function
+
+void CreateLockFreeQueue(LPPLOCKFREE_QUEUE lppQueue) {
+  if (lppQueue == NULL) {
+    return; // Required parameter
+  }
+
+  void* pvQueue = NULL;
+  if (posix_memalign(&pvQueue, 64, sizeof(LOCKFREE_QUEUE)) != 0) {
+    fprintf(stderr, FAILED_ALLOC_QUEUE);
+    *lppQueue = NULL;
+    return;
+  }
+
+  *lppQueue = (LPLOCKFREE_QUEUE) pvQueue;
+  memset(*lppQueue, 0, sizeof(LOCKFREE_QUEUE));
+
+  LPQUEUE_NODE lpDummy = (LPQUEUE_NODE) calloc(1, sizeof(QUEUE_NODE));
+  if (lpDummy == NULL) {
+    fprintf(stderr, FAILED_ALLOC_HEAD);
+    free(*lppQueue);
+    *lppQueue = NULL;
+    return;
+  }
+
+  (*lppQueue)->pHead = lpDummy;
+  (*lppQueue)->pTail = lpDummy;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DequeueElement function
+
+BOOL DequeueElement(LPLOCKFREE_QUEUE lpQueue, void** ppvData) {
+  if (lpQueue == NULL || ppvData == NULL) {
+    return FALSE; // Required parameters
+  }
+
+  LPHAZARD_RECORD lpRecord = AcquireHazardRecord(lpQueue);
+  if (lpRecord == NULL) {
+    return FALSE;
+  }
+
+  LPQUEUE_NODE lpHead = NULL;
+
+  while (TRUE) {
+    lpHead = __atomic_load_n(&(lpQueue->pHead), __ATOMIC_ACQUIRE);
+    __atomic_store_n(&(lpRecord->apHazards[0]), lpHead, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&(lpQueue->pHead), __ATOMIC_SEQ_CST) != lpHead) {
+      continue;
+    }
+
+    LPQUEUE_NODE lpTail = __atomic_load_n(&(lpQueue->pTail),
+        __ATOMIC_ACQUIRE);
+    LPQUEUE_NODE lpNext = __atomic_load_n(&(lpHead->pNext),
+        __ATOMIC_ACQUIRE);
+    __atomic_store_n(&(lpRecord->apHazards[1]), lpNext, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&(lpQueue->pHead), __ATOMIC_SEQ_CST) != lpHead) {
+      continue;
+    }
+
+    if (lpNext == NULL) {
+      ReleaseHazardRecord(lpRecord);
+      return FALSE; // Queue is empty
+    }
+
+    if (lpHead == lpTail) {
+      /* The tail is lagging behind an enqueue that is in progress; help
+       it along before trying again. */
+      __atomic_compare_exchange_n(&(lpQueue->pTail), &lpTail, lpNext, FALSE,
+          __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+      continue;
+    }
+
+    void* pvData = lpNext->pvData;
+    if (__atomic_compare_exchange_n(&(lpQueue->pHead), &lpHead, lpNext,
+        FALSE, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+      *ppvData = pvData;
+      break;
+    }
+  }
+
+  /* The old dummy node is now unreachable, but other threads may still be
+   looking at it, so it can only be retired, not freed. */
+  __atomic_store_n(&(lpRecord->apHazards[0]), NULL, __ATOMIC_RELEASE);
+  __atomic_store_n(&(lpRecord->apHazards[1]), NULL, __ATOMIC_RELEASE);
+  RetireNode(lpQueue, lpRecord, lpHead);
+
+  ReleaseHazardRecord(lpRecord);
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DestroyLockFreeQueue function
+
+void DestroyLockFreeQueue(LPPLOCKFREE_QUEUE lppQueue,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppQueue == NULL || *lppQueue == NULL) {
+    return; // Nothing to do
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  /* The head is the dummy node; its data, if any, has already been handed
+   out by DequeueElement. */
+  LPQUEUE_NODE lpNode = (*lppQueue)->pHead;
+  BOOL bDummy = TRUE;
+  while (lpNode != NULL) {
+    LPQUEUE_NODE lpNext = lpNode->pNext;
+    if (!bDummy) {
+      lpfnDeallocFunc(lpNode->pvData);
+    }
+    free(lpNode);
+    bDummy = FALSE;
+    lpNode = lpNext;
+  }
+
+  LPHAZARD_RECORD lpRecord = (*lppQueue)->pHazardRecords;
+  while (lpRecord != NULL) {
+    LPHAZARD_RECORD lpNext = lpRecord->pNext;
+    for (int i = 0; i < lpRecord->nRetiredCount; i++) {
+      free(lpRecord->ppRetired[i]);
+    }
+    free(lpRecord->ppRetired);
+    free(lpRecord);
+    lpRecord = lpNext;
+  }
+
+  free(*lppQueue);
+  *lppQueue = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// EnqueueElement function
+
+BOOL EnqueueElement(LPLOCKFREE_QUEUE lpQueue, void* pvData) {
+  if (lpQueue == NULL) {
+    return FALSE; // Required parameter
+  }
+
+  LPQUEUE_NODE lpNew = (LPQUEUE_NODE) malloc(sizeof(QUEUE_NODE));
+  if (lpNew == NULL) {
+    fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+    return FALSE;
+  }
+
+  lpNew->pvData = pvData;
+  lpNew->pNext = NULL;
+
+  LPHAZARD_RECORD lpRecord = AcquireHazardRecord(lpQueue);
+  if (lpRecord == NULL) {
+    free(lpNew);
+    return FALSE;
+  }
+
+  while (TRUE) {
+    LPQUEUE_NODE lpTail = __atomic_load_n(&(lpQueue->pTail),
+        __ATOMIC_ACQUIRE);
+    __atomic_store_n(&(lpRecord->apHazards[0]), lpTail, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&(lpQueue->pTail), __ATOMIC_SEQ_CST) != lpTail) {
+      continue;
+    }
+
+    LPQUEUE_NODE lpNext = __atomic_load_n(&(lpTail->pNext),
+        __ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&(lpQueue->pTail), __ATOMIC_ACQUIRE) != lpTail) {
+      continue;
+    }
+
+    if (lpNext != NULL) {
+      /* Another enqueue has linked its node but not yet swung the tail;
+       help it along before trying again. */
+      __atomic_compare_exchange_n(&(lpQueue->pTail), &lpTail, lpNext, FALSE,
+          __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+      continue;
+    }
+
+    LPQUEUE_NODE lpExpected = NULL;
+    if (__atomic_compare_exchange_n(&(lpTail->pNext), &lpExpected, lpNew,
+        FALSE, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+      __atomic_compare_exchange_n(&(lpQueue->pTail), &lpTail, lpNew, FALSE,
+          __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+      break;
+    }
+  }
+
+  ReleaseHazardRecord(lpRecord);
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// IsLockFreeQueueEmpty function
+
+BOOL IsLockFreeQueueEmpty(LPLOCKFREE_QUEUE lpQueue) {
+  if (lpQueue == NULL) {
+    return TRUE;
+  }
+
+  LPHAZARD_RECORD lpRecord = AcquireHazardRecord(lpQueue);
+  if (lpRecord == NULL) {
+    return TRUE;
+  }
+
+  BOOL bResult = FALSE;
+
+  while (TRUE) {
+    LPQUEUE_NODE lpHead = __atomic_load_n(&(lpQueue->pHead),
+        __ATOMIC_ACQUIRE);
+    __atomic_store_n(&(lpRecord->apHazards[0]), lpHead, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&(lpQueue->pHead), __ATOMIC_SEQ_CST) != lpHead) {
+      continue;
+    }
+
+    bResult = __atomic_load_n(&(lpHead->pNext), __ATOMIC_ACQUIRE) == NULL;
+    break;
+  }
+
+  ReleaseHazardRecord(lpRecord);
+
+  return bResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,475 @@
+// parallel.c - Implementations of functions that run the list_core aggregate
+// operations on several threads at once
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "parallel.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal types
+
+/**
+ * @brief Identifies which operation a parallel job carries out on each
+ * element.
+ */
+typedef enum _tagPARALLEL_OPERATION {
+  PARALLEL_FOR_EACH,
+  PARALLEL_COUNT_WHERE,
+  PARALLEL_SUM,
+  PARALLEL_SUM_WHERE
+} PARALLEL_OPERATION;
+
+/**
+ * @brief State shared by all the workers of one parallel operation.
+ */
+typedef struct _tagPARALLEL_JOB {
+  PARALLEL_OPERATION nOperation;
+  LPACTION_ROUTINE lpfnAction;
+  LPPREDICATE_ROUTINE lpfnPredicate;
+  LPSUMMATION_ROUTINE lpfnSumRoutine;
+  LPCOMPARE_ROUTINE lpfnCompare;
+  void* pvSearchKey;
+
+  void** ppvSnapshot;
+  int nCount;
+  int nSegmentSize;
+  int nSegmentCount;
+  int nNextSegment;         // Claimed atomically by the workers
+
+  long long* pnPartials;    // One per worker
+
+  int nWorkersSeated;       // Pool threads that have taken a seat
+  int nWorkersRunning;      // Pool threads still working on the job
+  pthread_cond_t workersDone; // Signalled when nWorkersRunning drops to zero
+} PARALLEL_JOB, *LPPARALLEL_JOB;
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal variables
+
+/**
+ * @brief Pool of threads that help the calling thread with parallel jobs.
+ * The pool is created on first use, and grows to the largest number of
+ * helpers that any job has asked for.  One job at a time is posted to it,
+ * with a number of seats; each thread that wakes up takes a seat, if one is
+ * left, and then works on the job until it has no segments left.  All of the
+ * members are protected by g_parallelPoolMutex.
+ */
+static pthread_mutex_t g_parallelPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_parallelJobPosted = PTHREAD_COND_INITIALIZER;
+static pthread_t* g_pParallelThreads = NULL;
+static int g_nParallelThreads = 0;
+static LPPARALLEL_JOB g_lpParallelJob = NULL; // Job posted, if any
+static int g_nParallelSeats = 0;    // Seats left on the posted job
+static BOOL g_bParallelShutdown = FALSE;
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateDataSnapshot function - Walks the list once from the head and copies
+// the data pointer of each element into a new array.  Returns the number of
+// elements, or ERROR if memory could not be allocated.
+
+static int CreateDataSnapshot(LPPOSITION lpElement, void*** pppvSnapshot) {
+  int nCount = 0;
+  int nCapacity = 1024;
+
+  *pppvSnapshot = NULL;
+
+  void** ppvSnapshot = (void**) malloc(nCapacity * sizeof(void*));
+  if (ppvSnapshot == NULL) {
+    return ERROR;
+  }
+
+  MoveToHeadPosition(&lpElement);
+
+  for (; lpElement != NULL; lpElement = lpElement->pNext) {
+    if (nCount == nCapacity) {
+      nCapacity *= 2;
+      void** ppvGrown = (void**) realloc(ppvSnapshot,
+          nCapacity * sizeof(void*));
+      if (ppvGrown == NULL) {
+        free(ppvSnapshot);
+        return ERROR;
+      }
+      ppvSnapshot = ppvGrown;
+    }
+    ppvSnapshot[nCount++] = lpElement->pvData;
+  }
+
+  *pppvSnapshot = ppvSnapshot;
+
+  return nCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ApplyJobOperation function - Carries out the job's operation on the data of
+// one element, and returns what it adds to the result.
+
+static inline long long ApplyJobOperation(LPPARALLEL_JOB lpJob,
+    void* pvData) {
+  switch (lpJob->nOperation) {
+    case PARALLEL_FOR_EACH:
+      lpJob->lpfnAction(pvData);
+      return 0;
+
+    case PARALLEL_COUNT_WHERE:
+      return lpJob->lpfnPredicate(pvData) ? 1 : 0;
+
+    case PARALLEL_SUM:
+      return lpJob->lpfnSumRoutine(pvData);
+
+    case PARALLEL_SUM_WHERE:
+      if (!lpJob->lpfnCompare(lpJob->pvSearchKey, pvData)) {
+        return 0; // Skip elements for which criteria is not met
+      }
+      return lpJob->lpfnSumRoutine(pvData);
+  }
+
+  return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RunJobSegments function - Claims segments of the job until there are none
+// left, and stores the result of the segments claimed as the partial result
+// of the specified worker.
+
+static void RunJobSegments(LPPARALLEL_JOB lpJob, int nWorker) {
+  long long nPartial = 0;
+
+  while (TRUE) {
+    int nSegment = __atomic_fetch_add(&(lpJob->nNextSegment), 1,
+        __ATOMIC_RELAXED);
+    if (nSegment >= lpJob->nSegmentCount) {
+      break;
+    }
+
+    int nBegin = nSegment * lpJob->nSegmentSize;
+    int nEnd = nBegin + lpJob->nSegmentSize;
+    if (nEnd > lpJob->nCount) {
+      nEnd = lpJob->nCount;
+    }
+
+    for (int i = nBegin; i < nEnd; i++) {
+      nPartial += ApplyJobOperation(lpJob, lpJob->ppvSnapshot[i]);
+    }
+  }
+
+  lpJob->pnPartials[nWorker] = nPartial;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ParallelPoolThread function - Body of each thread of the pool.  Waits for
+// a job with a seat left, helps with it, and goes back to waiting, until the
+// pool is shut down.
+
+static void* ParallelPoolThread(void* pvArgs) {
+  (void) pvArgs;
+
+  pthread_mutex_lock(&g_parallelPoolMutex);
+
+  while (!g_bParallelShutdown) {
+    if (g_lpParallelJob == NULL || g_nParallelSeats == 0) {
+      pthread_cond_wait(&g_parallelJobPosted, &g_parallelPoolMutex);
+      continue;
+    }
+
+    // Worker zero is the thread that posted the job
+    LPPARALLEL_JOB lpJob = g_lpParallelJob;
+    int nWorker = ++lpJob->nWorkersSeated;
+    lpJob->nWorkersRunning++;
+    g_nParallelSeats--;
+
+    pthread_mutex_unlock(&g_parallelPoolMutex);
+
+    RunJobSegments(lpJob, nWorker);
+
+    pthread_mutex_lock(&g_parallelPoolMutex);
+
+    if (--lpJob->nWorkersRunning == 0) {
+      pthread_cond_signal(&(lpJob->workersDone));
+    }
+  }
+
+  pthread_mutex_unlock(&g_parallelPoolMutex);
+
+  return NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// PostParallelJob function - Posts a job to the pool, with up to nHelpers
+// seats, starting threads first if the pool has fewer than that.  If another
+// job is using the pool, e.g., because a callback of that job has itself
+// started a parallel operation, nothing is posted.  Returns the number of
+// seats posted.
+
+static int PostParallelJob(LPPARALLEL_JOB lpJob, int nHelpers) {
+  pthread_mutex_lock(&g_parallelPoolMutex);
+
+  if (g_lpParallelJob != NULL || g_bParallelShutdown) {
+    pthread_mutex_unlock(&g_parallelPoolMutex);
+    return 0;
+  }
+
+  if (g_nParallelThreads < nHelpers) {
+    pthread_t* pThreads = (pthread_t*) realloc(g_pParallelThreads,
+        nHelpers * sizeof(pthread_t));
+    if (pThreads != NULL) {
+      g_pParallelThreads = pThreads;
+      while (g_nParallelThreads < nHelpers
+          && pthread_create(&(pThreads[g_nParallelThreads]), NULL,
+              ParallelPoolThread, NULL) == 0) {
+        g_nParallelThreads++;
+      }
+    }
+  }
+
+  if (nHelpers > g_nParallelThreads) {
+    nHelpers = g_nParallelThreads;
+  }
+
+  if (nHelpers > 0) {
+    g_lpParallelJob = lpJob;
+    g_nParallelSeats = nHelpers;
+    pthread_cond_broadcast(&g_parallelJobPosted);
+  }
+
+  pthread_mutex_unlock(&g_parallelPoolMutex);
+
+  return nHelpers;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// WithdrawParallelJob function - Withdraws the seats of a job that nobody has
+// taken yet, and waits for the pool threads that did take one to finish.
+
+static void WithdrawParallelJob(LPPARALLEL_JOB lpJob) {
+  pthread_mutex_lock(&g_parallelPoolMutex);
+
+  g_lpParallelJob = NULL;
+  g_nParallelSeats = 0;
+
+  while (lpJob->nWorkersRunning > 0) {
+    pthread_cond_wait(&(lpJob->workersDone), &g_parallelPoolMutex);
+  }
+
+  pthread_mutex_unlock(&g_parallelPoolMutex);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RunSerialJob function - Carries out the job's operation on each element of
+// the list, on the calling thread.  Used when a parallel job cannot be set
+// up.  Returns the result.
+
+static long long RunSerialJob(LPPOSITION lpElement, LPPARALLEL_JOB lpJob) {
+  long long nResult = 0;
+
+  MoveToHeadPosition(&lpElement);
+
+  for (; lpElement != NULL; lpElement = lpElement->pNext) {
+    nResult += ApplyJobOperation(lpJob, lpElement->pvData);
+  }
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RunParallelJob function - Snapshots the list, runs the job on the calling
+// thread and on as many threads of the pool as are wanted, and adds up the
+// partial results.  If memory for the snapshot or the partial results cannot
+// be allocated, the job is run on the calling thread alone instead, by
+// walking the list.  Returns the result.
+
+static long long RunParallelJob(LPPOSITION lpElement, LPPARALLEL_JOB lpJob,
+    LPPARALLEL_OPTIONS lpOptions) {
+  int nThreadCount = 0;
+  lpJob->nSegmentSize = PARALLEL_DEFAULT_SEGMENT_SIZE;
+
+  if (lpOptions != NULL) {
+    nThreadCount = lpOptions->nThreadCount;
+    if (lpOptions->nSegmentSize > 0) {
+      lpJob->nSegmentSize = lpOptions->nSegmentSize;
+    }
+  }
+
+  if (nThreadCount <= 0) {
+    nThreadCount = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (nThreadCount <= 0) {
+      nThreadCount = 1;
+    }
+  }
+
+  lpJob->nCount = CreateDataSnapshot(lpElement, &(lpJob->ppvSnapshot));
+  if (lpJob->nCount < 0) {
+    return RunSerialJob(lpElement, lpJob);
+  }
+
+  lpJob->nSegmentCount =
+      (lpJob->nCount + lpJob->nSegmentSize - 1) / lpJob->nSegmentSize;
+  lpJob->nNextSegment = 0;
+
+  if (nThreadCount > lpJob->nSegmentCount) {
+    nThreadCount = lpJob->nSegmentCount > 0 ? lpJob->nSegmentCount : 1;
+  }
+
+  lpJob->pnPartials = (long long*) calloc(nThreadCount, sizeof(long long));
+  if (lpJob->pnPartials == NULL) {
+    free(lpJob->ppvSnapshot);
+    return RunSerialJob(lpElement, lpJob);
+  }
+
+  /* Worker zero is the calling thread.  If the pool cannot supply all of the
+   other workers, those that it does supply simply claim more segments. */
+  int nHelpers = 0;
+  if (nThreadCount > 1) {
+    pthread_cond_init(&(lpJob->workersDone), NULL);
+    nHelpers = PostParallelJob(lpJob, nThreadCount - 1);
+  }
+
+  RunJobSegments(lpJob, 0);
+
+  if (nThreadCount > 1) {
+    if (nHelpers > 0) {
+      WithdrawParallelJob(lpJob);
+    }
+    pthread_cond_destroy(&(lpJob->workersDone));
+  }
+
+  /* The partial results are integers, so they add up to the same total
+   however the segments were shared out between the workers. */
+  long long nResult = 0;
+  for (int i = 0; i < nThreadCount; i++) {
+    nResult += lpJob->pnPartials[i];
+  }
+
+  free(lpJob->pnPartials);
+  free(lpJob->ppvSnapshot);
+
+  return nResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// DoForEachParallel function
+
+void DoForEachParallel(LPPOSITION lpElement, LPACTION_ROUTINE lpfnAction,
+    LPPARALLEL_OPTIONS lpOptions) {
+  if (lpElement == NULL || lpfnAction == NULL) {
+    return;
+  }
+
+  PARALLEL_JOB job;
+  memset(&job, 0, sizeof(PARALLEL_JOB));
+  job.nOperation = PARALLEL_FOR_EACH;
+  job.lpfnAction = lpfnAction;
+
+  RunParallelJob(lpElement, &job, lpOptions);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetElementCountWhereParallel function
+
+int64_t GetElementCountWhereParallel(LPPOSITION lpElement,
+    LPPREDICATE_ROUTINE lpfnPredicate, LPPARALLEL_OPTIONS lpOptions) {
+  if (lpElement == NULL || lpfnPredicate == NULL) {
+    return 0;
+  }
+
+  PARALLEL_JOB job;
+  memset(&job, 0, sizeof(PARALLEL_JOB));
+  job.nOperation = PARALLEL_COUNT_WHERE;
+  job.lpfnPredicate = lpfnPredicate;
+
+  return (int64_t) RunParallelJob(lpElement, &job, lpOptions);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ShutdownParallelWorkers function
+
+void ShutdownParallelWorkers(void) {
+  pthread_mutex_lock(&g_parallelPoolMutex);
+
+  g_bParallelShutdown = TRUE;
+  pthread_cond_broadcast(&g_parallelJobPosted);
+
+  pthread_t* pThreads = g_pParallelThreads;
+  int nThreads = g_nParallelThreads;
+
+  pthread_mutex_unlock(&g_parallelPoolMutex);
+
+  for (int i = 0; i < nThreads; i++) {
+    pthread_join(pThreads[i], NULL);
+  }
+
+  pthread_mutex_lock(&g_parallelPoolMutex);
+
+  free(g_pParallelThreads);
+  g_pParallelThreads = NULL;
+  g_nParallelThreads = 0;
+  g_bParallelShutdown = FALSE;  // The next job starts a new pool
+
+  pthread_mutex_unlock(&g_parallelPoolMutex);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumElementsParallel function
+
+int64_t SumElementsParallel(LPPOSITION lpElement,
+    LPSUMMATION_ROUTINE lpfnSumRoutine, LPPARALLEL_OPTIONS lpOptions) {
+  if (lpElement == NULL || lpfnSumRoutine == NULL) {
+    return ERROR;  // Required parameters
+  }
+
+  PARALLEL_JOB job;
+  memset(&job, 0, sizeof(PARALLEL_JOB));
+  job.nOperation = PARALLEL_SUM;
+  job.lpfnSumRoutine = lpfnSumRoutine;
+
+  return (int64_t) RunParallelJob(lpElement, &job, lpOptions);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SumElementsWhereParallel function
+
+int64_t SumElementsWhereParallel(LPPOSITION lpElement,
+    LPSUMMATION_ROUTINE lpfnSumRoutine, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareRoutine, LPPARALLEL_OPTIONS lpOptions) {
+  if (lpElement == NULL) {
+    return 0; // No elements in linked list at all; sum is obviously 0
+  }
+
+  if (lpfnSumRoutine == NULL || pvSearchKey == NULL
+      || lpfnCompareRoutine == NULL) {
+    return ERROR; // Required parameters
+  }
+
+  PARALLEL_JOB job;
+  memset(&job, 0, sizeof(PARALLEL_JOB));
+  job.nOperation = PARALLEL_SUM_WHERE;
+  job.lpfnSumRoutine = lpfnSumRoutine;
+  job.lpfnCompare = lpfnCompareRoutine;
+  job.pvSearchKey = pvSearchKey;
+
+  return (int64_t) RunParallelJob(lpElement, &job, lpOptions);
+}
+
+//////////////////////////////////////////////////////////////////////////////
@@ -21,6 +21,7 @@
 #include "list_core.h"
 
 #include "position.h"
+#include "list_stats_internal.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // Publicly-exposed functions
@@ -31,6 +32,12 @@ void CreatePosition(LPPPOSITION lppPosition) {
 	}
 
 	*lppPosition = (LPPOSITION) malloc(sizeof(POSITION));
+	if (*lppPosition == NULL) {
+		return;	// Out of memory; callers check for NULL
+	}
+
+	LIST_STATS_COUNT(nAllocations, 1);
+
 	memset(*lppPosition, 0, sizeof(POSITION));
 }
 
@@ -41,6 +48,8 @@ void DestroyPosition(LPPPOSITION lppPosition) {
 
 	free((void*) (*lppPosition));
 	*lppPosition = NULL;
+
+	LIST_STATS_COUNT(nFrees, 1);
 }
 
 LPPOSITION GetHeadPosition(LPPOSITION lpElement) {
@@ -76,11 +85,11 @@ LPPOSITION GetTailPosition(LPPOSITION lpElement) {
 		return NULL; // List has zero elements
 	}
 
-	if (IsPositionHead(lpElement)) {
+	if (IsPositionTail(lpElement)) {
 		return lpElement;
 	}
 
-	MoveToHeadPosition(&lpElement);
+	MoveToTailPosition(&lpElement);
 
 	return lpElement;
 }
@@ -112,6 +121,8 @@ void MoveToHeadPosition(LPPPOSITION lppElement) {
 		return;  // nothing in the list to do anything with
 	}
 
+	LIST_STATS_COUNT(nHeadSeeks, 1);
+
 	do {
 		/* If we are already given a position that points
 		 to the head, there is nothing to do but return
@@ -119,6 +130,8 @@ void MoveToHeadPosition(LPPPOSITION lppElement) {
 		if (IsPositionHead(*lppElement)) {
 			return;
 		}
+
+		LIST_STATS_COUNT(nNodesTraversed, 1);
 	} while ((*lppElement = GetPrevPosition(*lppElement)) != NULL);
 }
 
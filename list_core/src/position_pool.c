@@ -0,0 +1,297 @@
+// position_pool.c - Implementations of functions that allocate POSITION nodes
+// out of large slabs and recycle them through a free list
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "position.h"
+#include "position_pool.h"
+#include "list_stats_internal.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+static void LockPositionPool(LPPOSITION_POOL lpPool) {
+  if (lpPool->bThreadSafe) {
+    pthread_mutex_lock(&(lpPool->mutex));
+  }
+}
+
+static void UnlockPositionPool(LPPOSITION_POOL lpPool) {
+  if (lpPool->bThreadSafe) {
+    pthread_mutex_unlock(&(lpPool->mutex));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AddPositionSlab function - Allocates a new slab with room for at least
+// nCapacity nodes and makes it the pool's current slab.  Must be called with
+// the pool locked.
+
+static LPPOSITION_SLAB AddPositionSlab(LPPOSITION_POOL lpPool,
+    int nCapacity) {
+  size_t nBytes = sizeof(POSITION_SLAB) + (size_t) nCapacity * sizeof(POSITION);
+
+  LPPOSITION_SLAB lpSlab = (LPPOSITION_SLAB) malloc(nBytes);
+  if (lpSlab == NULL) {
+    return NULL;
+  }
+
+  lpSlab->nCapacity = nCapacity;
+  lpSlab->nUsed = 0;
+  lpSlab->pNext = lpPool->pSlabs;
+  lpPool->pSlabs = lpSlab;
+
+  lpPool->stats.nSlabCount++;
+  lpPool->stats.nSlabBytes += (long) nBytes;
+
+  return lpSlab;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ReleasePositionSlabs function - Frees every slab held by the pool.  Must be
+// called with the pool locked.
+
+static void ReleasePositionSlabs(LPPOSITION_POOL lpPool) {
+  LPPOSITION_SLAB lpSlab = lpPool->pSlabs;
+  while (lpSlab != NULL) {
+    LPPOSITION_SLAB lpNext = lpSlab->pNext;
+    free(lpSlab);
+    lpSlab = lpNext;
+  }
+
+  lpPool->pSlabs = NULL;
+  lpPool->pFreeList = NULL;
+
+  lpPool->stats.nSlabCount = 0;
+  lpPool->stats.nSlabBytes = 0;
+  lpPool->stats.nFreeListLength = 0;
+  lpPool->stats.nTotalFrees += lpPool->stats.nActivePositions;
+  LIST_STATS_COUNT(nFrees, lpPool->stats.nActivePositions);
+  lpPool->stats.nActivePositions = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AllocPoolPosition function
+
+void AllocPoolPosition(LPPOSITION_POOL lpPool, LPPPOSITION lppPosition) {
+  if (lppPosition == NULL) {
+    return; // Required parameter
+  }
+
+  *lppPosition = NULL;
+
+  if (lpPool == NULL) {
+    return; // Required parameter
+  }
+
+  LockPositionPool(lpPool);
+
+  LPPOSITION lpResult = lpPool->pFreeList;
+  if (lpResult != NULL) {
+    lpPool->pFreeList = lpResult->pNext;
+    lpPool->stats.nFreeListLength--;
+  } else {
+    LPPOSITION_SLAB lpSlab = lpPool->pSlabs;
+    if (lpSlab == NULL || lpSlab->nUsed == lpSlab->nCapacity) {
+      lpSlab = AddPositionSlab(lpPool, lpPool->nSlabSize);
+    }
+    if (lpSlab != NULL) {
+      lpResult = &(lpSlab->aPositions[lpSlab->nUsed++]);
+    }
+  }
+
+  if (lpResult != NULL) {
+    lpPool->stats.nTotalAllocations++;
+    lpPool->stats.nActivePositions++;
+    if (lpPool->stats.nActivePositions > lpPool->stats.nPeakActivePositions) {
+      lpPool->stats.nPeakActivePositions = lpPool->stats.nActivePositions;
+    }
+  }
+
+  UnlockPositionPool(lpPool);
+
+  if (lpResult == NULL) {
+    return; // Out of memory
+  }
+
+  LIST_STATS_COUNT(nAllocations, 1);
+
+  memset(lpResult, 0, sizeof(POSITION));
+
+  *lppPosition = lpResult;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AllocPoolPositions function
+
+void AllocPoolPositions(LPPOSITION_POOL lpPool, int nCount,
+    LPPPOSITION lppPositions) {
+  if (lppPositions == NULL) {
+    return; // Required parameter
+  }
+
+  *lppPositions = NULL;
+
+  if (lpPool == NULL || nCount <= 0) {
+    return; // Required parameters
+  }
+
+  LockPositionPool(lpPool);
+
+  LPPOSITION_SLAB lpSlab = lpPool->pSlabs;
+  if (lpSlab == NULL || lpSlab->nCapacity - lpSlab->nUsed < nCount) {
+    if (nCount > lpPool->nSlabSize && lpSlab != NULL) {
+      /* An oversized request gets a slab of its own, which is placed behind
+       the current slab so that the latter's remaining room is not lost. */
+      lpSlab = AddPositionSlab(lpPool, nCount);
+      if (lpSlab != NULL) {
+        lpPool->pSlabs = lpSlab->pNext;
+        lpSlab->pNext = lpPool->pSlabs->pNext;
+        lpPool->pSlabs->pNext = lpSlab;
+      }
+    } else {
+      lpSlab = AddPositionSlab(lpPool,
+          nCount > lpPool->nSlabSize ? nCount : lpPool->nSlabSize);
+    }
+  }
+
+  if (lpSlab != NULL) {
+    *lppPositions = &(lpSlab->aPositions[lpSlab->nUsed]);
+    lpSlab->nUsed += nCount;
+
+    lpPool->stats.nTotalAllocations += nCount;
+    lpPool->stats.nActivePositions += nCount;
+    LIST_STATS_COUNT(nAllocations, nCount);
+    if (lpPool->stats.nActivePositions > lpPool->stats.nPeakActivePositions) {
+      lpPool->stats.nPeakActivePositions = lpPool->stats.nActivePositions;
+    }
+  }
+
+  UnlockPositionPool(lpPool);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreatePositionPool function
+
+void CreatePositionPool(LPPPOSITION_POOL lppPool, int nSlabSize,
+    BOOL bThreadSafe) {
+  if (lppPool == NULL) {
+    return; // Required parameter
+  }
+
+  *lppPool = (LPPOSITION_POOL) malloc(sizeof(POSITION_POOL));
+  if (*lppPool == NULL) {
+    return;
+  }
+
+  memset(*lppPool, 0, sizeof(POSITION_POOL));
+
+  (*lppPool)->nSlabSize =
+      nSlabSize > 0 ? nSlabSize : POSITION_POOL_DEFAULT_SLAB_SIZE;
+  (*lppPool)->bThreadSafe = bThreadSafe;
+
+  if (bThreadSafe) {
+    pthread_mutex_init(&((*lppPool)->mutex), NULL);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DestroyPositionPool function
+
+void DestroyPositionPool(LPPPOSITION_POOL lppPool) {
+  if (lppPool == NULL || *lppPool == NULL) {
+    return; // Nothing to do
+  }
+
+  ReleasePositionSlabs(*lppPool);
+
+  if ((*lppPool)->bThreadSafe) {
+    pthread_mutex_destroy(&((*lppPool)->mutex));
+  }
+
+  free(*lppPool);
+  *lppPool = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FreePoolPosition function
+
+void FreePoolPosition(LPPOSITION_POOL lpPool, LPPPOSITION lppPosition) {
+  if (lpPool == NULL) {
+    return; // Required parameter
+  }
+
+  if (lppPosition == NULL || *lppPosition == NULL) {
+    return; // Nothing to do
+  }
+
+  LockPositionPool(lpPool);
+
+  (*lppPosition)->pvData = NULL;
+  (*lppPosition)->pPrev = NULL;
+  (*lppPosition)->pNext = lpPool->pFreeList;
+  lpPool->pFreeList = *lppPosition;
+
+  lpPool->stats.nFreeListLength++;
+  lpPool->stats.nTotalFrees++;
+  lpPool->stats.nActivePositions--;
+
+  UnlockPositionPool(lpPool);
+
+  LIST_STATS_COUNT(nFrees, 1);
+
+  *lppPosition = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetPositionPoolStats function
+
+void GetPositionPoolStats(LPPOSITION_POOL lpPool,
+    LPPOSITION_POOL_STATS lpStats) {
+  if (lpPool == NULL || lpStats == NULL) {
+    return; // Required parameters
+  }
+
+  LockPositionPool(lpPool);
+
+  *lpStats = lpPool->stats;
+
+  UnlockPositionPool(lpPool);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ResetPositionPool function
+
+void ResetPositionPool(LPPOSITION_POOL lpPool) {
+  if (lpPool == NULL) {
+    return; // Required parameter
+  }
+
+  LockPositionPool(lpPool);
+
+  ReleasePositionSlabs(lpPool);
+
+  UnlockPositionPool(lpPool);
+}
+
+//////////////////////////////////////////////////////////////////////////////
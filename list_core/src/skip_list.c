@@ -0,0 +1,394 @@
+// skip_list.c - Implementations of functions that provide the functionality
+// of a linked list that is kept in order and can be searched in logarithmic
+// time
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "skip_list.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AllocSkipNode function - Allocates a node with a tower of the specified
+// height, all of whose links are NULL.
+
+static LPSKIP_NODE AllocSkipNode(int nLevel) {
+  LPSKIP_NODE lpNode = (LPSKIP_NODE) calloc(1,
+      sizeof(SKIP_NODE) + nLevel * sizeof(LPSKIP_NODE));
+  if (lpNode == NULL) {
+    return NULL;
+  }
+
+  lpNode->nLevel = nLevel;
+
+  return lpNode;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ChooseSkipLevel function - Picks the height of a new node's tower, such
+// that each additional level is four times less likely than the last.
+
+static int ChooseSkipLevel(LPSKIP_LIST lpList) {
+  /* xorshift32; cheap, and plenty random enough for balancing. */
+  unsigned int nBits = lpList->nRandomState;
+  nBits ^= nBits << 13;
+  nBits ^= nBits >> 17;
+  nBits ^= nBits << 5;
+  lpList->nRandomState = nBits;
+
+  int nLevel = 1;
+  while ((nBits & 3) == 0 && nLevel < SKIP_LIST_MAX_LEVEL) {
+    nLevel++;
+    nBits >>= 2;
+  }
+
+  return nLevel;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindSkipPredecessors function - Descends the towers from the top level, and
+// stores in apUpdate, for each level, the last node whose data sorts before
+// the key (or, if bAfterEquivalents is TRUE, does not sort after it).
+// Returns the node that follows the predecessor on the bottom level.
+
+static LPSKIP_NODE FindSkipPredecessors(LPSKIP_LIST lpList, void* pvKey,
+    BOOL bAfterEquivalents, LPSKIP_NODE* apUpdate) {
+  LPSKIP_NODE lpNode = lpList->pHeader;
+
+  for (int i = lpList->nLevel - 1; i >= 0; i--) {
+    LPSKIP_NODE lpNext = lpNode->apForward[i];
+    while (lpNext != NULL) {
+      int nOrder = lpList->lpfnCompare(lpNext->position.pvData, pvKey);
+      if (nOrder > 0 || (nOrder == 0 && !bAfterEquivalents)) {
+        break;
+      }
+      lpNode = lpNext;
+      lpNext = lpNode->apForward[i];
+    }
+
+    if (apUpdate != NULL) {
+      apUpdate[i] = lpNode;
+    }
+  }
+
+  return lpNode->apForward[0];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// UnlinkSkipNode function - Detaches a node from every level of the list,
+// given its predecessor on each level of its tower, and from the POSITION
+// chain.
+
+static void UnlinkSkipNode(LPSKIP_LIST lpList, LPSKIP_NODE lpNode,
+    LPSKIP_NODE* apUpdate) {
+  for (int i = 0; i < lpNode->nLevel; i++) {
+    apUpdate[i]->apForward[i] = lpNode->apForward[i];
+  }
+
+  LPPOSITION lpPrev = lpNode->position.pPrev;
+  LPPOSITION lpNext = lpNode->position.pNext;
+  if (lpPrev != NULL) {
+    lpPrev->pNext = lpNext;
+  }
+  if (lpNext != NULL) {
+    lpNext->pPrev = lpPrev;
+  }
+
+  while (lpList->nLevel > 1
+      && lpList->pHeader->apForward[lpList->nLevel - 1] == NULL) {
+    lpList->nLevel--;
+  }
+
+  lpList->nCount--;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AddSkipListElement function
+
+LPPOSITION AddSkipListElement(LPSKIP_LIST lpList, void* pvData) {
+  if (lpList == NULL) {
+    return NULL; // Required parameter
+  }
+
+  LPSKIP_NODE apUpdate[SKIP_LIST_MAX_LEVEL];
+  LPSKIP_NODE lpNext = FindSkipPredecessors(lpList, pvData, TRUE, apUpdate);
+
+  int nLevel = ChooseSkipLevel(lpList);
+
+  LPSKIP_NODE lpNew = AllocSkipNode(nLevel);
+  if (lpNew == NULL) {
+    fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+    return NULL;
+  }
+
+  lpNew->position.pvData = pvData;
+
+  for (; lpList->nLevel < nLevel; lpList->nLevel++) {
+    apUpdate[lpList->nLevel] = lpList->pHeader;
+  }
+
+  for (int i = 0; i < nLevel; i++) {
+    lpNew->apForward[i] = apUpdate[i]->apForward[i];
+    apUpdate[i]->apForward[i] = lpNew;
+  }
+
+  /* The header is not an element, so it does not take part in the POSITION
+   chain. */
+  if (apUpdate[0] != lpList->pHeader) {
+    lpNew->position.pPrev = &(apUpdate[0]->position);
+    apUpdate[0]->position.pNext = &(lpNew->position);
+  }
+  if (lpNext != NULL) {
+    lpNew->position.pNext = &(lpNext->position);
+    lpNext->position.pPrev = &(lpNew->position);
+  }
+
+  lpList->nCount++;
+
+  return &(lpNew->position);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ClearSkipList function
+
+void ClearSkipList(LPSKIP_LIST lpList, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpList == NULL) {
+    return; // Nothing to do
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  LPSKIP_NODE lpNode = lpList->pHeader->apForward[0];
+  while (lpNode != NULL) {
+    LPSKIP_NODE lpNext = lpNode->apForward[0];
+    lpfnDeallocFunc(lpNode->position.pvData);
+    free(lpNode);
+    lpNode = lpNext;
+  }
+
+  memset(lpList->pHeader->apForward, 0,
+      SKIP_LIST_MAX_LEVEL * sizeof(LPSKIP_NODE));
+  lpList->nLevel = 1;
+  lpList->nCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateSkipList function
+
+void CreateSkipList(LPPSKIP_LIST lppList, LPSORT_COMPARE_ROUTINE lpfnCompare) {
+  if (lppList == NULL) {
+    return; // Required parameter
+  }
+
+  if (lpfnCompare == NULL) {
+    *lppList = NULL;
+    return; // Required parameter
+  }
+
+  *lppList = (LPSKIP_LIST) malloc(sizeof(SKIP_LIST));
+  if (*lppList == NULL) {
+    fprintf(stderr, FAILED_ALLOC_LIST);
+    return;
+  }
+
+  (*lppList)->pHeader = AllocSkipNode(SKIP_LIST_MAX_LEVEL);
+  if ((*lppList)->pHeader == NULL) {
+    fprintf(stderr, FAILED_ALLOC_HEAD);
+    free(*lppList);
+    *lppList = NULL;
+    return;
+  }
+
+  (*lppList)->nLevel = 1;
+  (*lppList)->nCount = 0;
+  (*lppList)->lpfnCompare = lpfnCompare;
+
+  /* Seed each list differently, but never with zero, which xorshift would
+   never leave. */
+  (*lppList)->nRandomState = (unsigned int) (unsigned long) *lppList
+      ^ 0x9E3779B9U;
+  if ((*lppList)->nRandomState == 0) {
+    (*lppList)->nRandomState = 0x9E3779B9U;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DestroySkipList function
+
+void DestroySkipList(LPPSKIP_LIST lppList, LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppList == NULL || *lppList == NULL) {
+    return; // Nothing to do
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  ClearSkipList(*lppList, lpfnDeallocFunc);
+
+  free((*lppList)->pHeader);
+  free(*lppList);
+  *lppList = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DoForEachSkipListElementInRange function
+
+void DoForEachSkipListElementInRange(LPSKIP_LIST lpList, void* pvLowKey,
+    void* pvHighKey, LPACTION_ROUTINE lpfnAction) {
+  if (lpList == NULL || lpfnAction == NULL) {
+    return;
+  }
+
+  LPSKIP_NODE lpNode = pvLowKey != NULL
+      ? FindSkipPredecessors(lpList, pvLowKey, FALSE, NULL)
+      : lpList->pHeader->apForward[0];
+
+  while (lpNode != NULL) {
+    if (pvHighKey != NULL
+        && lpList->lpfnCompare(lpNode->position.pvData, pvHighKey) > 0) {
+      break;
+    }
+
+    lpfnAction(lpNode->position.pvData);
+    lpNode = lpNode->apForward[0];
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindSkipListElement function
+
+LPPOSITION FindSkipListElement(LPSKIP_LIST lpList, void* pvSearchKey) {
+  if (lpList == NULL) {
+    return NULL; // Required parameter
+  }
+
+  LPSKIP_NODE lpNode = FindSkipPredecessors(lpList, pvSearchKey, FALSE, NULL);
+  if (lpNode == NULL
+      || lpList->lpfnCompare(lpNode->position.pvData, pvSearchKey) != 0) {
+    return NULL; // No element's data is equivalent to the key
+  }
+
+  return &(lpNode->position);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetSkipListElementCount function
+
+int GetSkipListElementCount(LPSKIP_LIST lpList) {
+  if (lpList == NULL) {
+    return 0;
+  }
+
+  return lpList->nCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetSkipListHead function
+
+LPPOSITION GetSkipListHead(LPSKIP_LIST lpList) {
+  if (lpList == NULL || lpList->pHeader->apForward[0] == NULL) {
+    return NULL;
+  }
+
+  return &(lpList->pHeader->apForward[0]->position);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveSkipListElement function
+
+LPPOSITION RemoveSkipListElement(LPSKIP_LIST lpList, LPPOSITION lpElement,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lpList == NULL || lpElement == NULL) {
+    return NULL; // Required parameters
+  }
+
+  if (lpfnDeallocFunc == NULL) {
+    return NULL; // Required parameter
+  }
+
+  LPSKIP_NODE lpTarget = (LPSKIP_NODE) lpElement;
+  LPSKIP_NODE apUpdate[SKIP_LIST_MAX_LEVEL];
+  LPSKIP_NODE lpNode = FindSkipPredecessors(lpList, lpElement->pvData, FALSE,
+      apUpdate);
+
+  /* Several elements may be equivalent to the target; step over those that
+   come before it, keeping track of the last node on each level. */
+  while (lpNode != NULL && lpNode != lpTarget) {
+    for (int i = 0; i < lpNode->nLevel; i++) {
+      apUpdate[i] = lpNode;
+    }
+    lpNode = lpNode->apForward[0];
+  }
+
+  if (lpNode == NULL) {
+    return NULL; // Element does not belong to this list
+  }
+
+  LPPOSITION lpNext = lpElement->pNext;
+
+  UnlinkSkipNode(lpList, lpTarget, apUpdate);
+
+  lpfnDeallocFunc(lpTarget->position.pvData);
+  free(lpTarget);
+
+  return lpNext;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveSkipListElementWhere function
+
+int RemoveSkipListElementWhere(LPSKIP_LIST lpList, void* pvSearchKey,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  int nRemoved = 0;
+
+  if (lpList == NULL || lpfnDeallocFunc == NULL) {
+    return nRemoved; // Required parameters
+  }
+
+  LPSKIP_NODE apUpdate[SKIP_LIST_MAX_LEVEL];
+  LPSKIP_NODE lpNode = FindSkipPredecessors(lpList, pvSearchKey, FALSE,
+      apUpdate);
+
+  /* The matching nodes are contiguous, and each is in turn the first node
+   after the predecessors on every level of its tower. */
+  while (lpNode != NULL
+      && lpList->lpfnCompare(lpNode->position.pvData, pvSearchKey) == 0) {
+    LPSKIP_NODE lpNext = lpNode->apForward[0];
+
+    UnlinkSkipNode(lpList, lpNode, apUpdate);
+
+    lpfnDeallocFunc(lpNode->position.pvData);
+    free(lpNode);
+    nRemoved++;
+
+    lpNode = lpNext;
+  }
+
+  return nRemoved;
+}
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,511 @@
+// versioned_list.c - Provides the implementation of the functions that manage
+// a versioned list, which readers scan through consistent views while writers
+// keep changing it
+//
+// This file is part of list_core.
+//
+// list_core is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// list_core is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with list_core.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "stdafx.h"
+#include "list_core.h"
+
+#include "versioned_list.h"
+
+/**
+ * @brief Value of the nDeath member of a node whose element has not been
+ * removed.
+ */
+#define VERSIONED_NODE_LIVE UINT64_MAX
+
+//////////////////////////////////////////////////////////////////////////////
+// Internal functions
+
+//////////////////////////////////////////////////////////////////////////////
+// FreeRetiredNodes function - Retires the chain of nodes that the caller has
+// just unlinked, if any, and then frees each retired node, and its data, that
+// no open view can be walking through.  The stamp is taken after the nodes
+// were unlinked, under the same lock that views take when they are opened, so
+// that a view with a sequence number of at least the stamp is known to have
+// been opened after the nodes could no longer be reached.  Stamps never
+// decrease, so the nodes are retired at the tail of the list of retired nodes,
+// and freed from its head up to the first one that must be kept.  Must be
+// called by a writer.  Returns the number of nodes freed.
+
+static int FreeRetiredNodes(LPVERSIONED_LIST lpList,
+    LPVERSIONED_NODE lpUnlinked) {
+  if (lpUnlinked == NULL && lpList->pRetired == NULL) {
+    return 0; // Nothing to do
+  }
+
+  pthread_mutex_lock(&(lpList->viewMutex));
+
+  uint64_t nStamp = lpList->nNextSequence;
+  uint64_t nOldestSequence = lpList->pOldestView != NULL
+      ? lpList->pOldestView->nSequence : nStamp;
+
+  pthread_mutex_unlock(&(lpList->viewMutex));
+
+  while (lpUnlinked != NULL) {
+    LPVERSIONED_NODE lpNext = lpUnlinked->pNextRetired;
+
+    lpUnlinked->nRetired = nStamp;
+    lpUnlinked->pNextRetired = NULL;
+    if (lpList->pRetiredTail == NULL) {
+      lpList->pRetired = lpUnlinked;
+    } else {
+      lpList->pRetiredTail->pNextRetired = lpUnlinked;
+    }
+    lpList->pRetiredTail = lpUnlinked;
+
+    lpUnlinked = lpNext;
+  }
+
+  int nFreed = 0;
+
+  while (lpList->pRetired != NULL) {
+    LPVERSIONED_NODE lpNode = lpList->pRetired;
+
+    if (lpNode->nRetired > nOldestSequence) {
+      break;  // A view that was open when it was unlinked is still open
+    }
+
+    lpList->pRetired = lpNode->pNextRetired;
+    if (lpList->pRetired == NULL) {
+      lpList->pRetiredTail = NULL;
+    }
+
+    lpList->lpfnDeallocFunc(lpNode->pvData);
+    free(lpNode);
+    nFreed++;
+  }
+
+  return nFreed;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetFirstViewNode function - Gets the first node that a view has to look at.
+// Writers link nodes with release stores, so that a reader that follows a
+// link also sees the node that it points to fully initialized.
+
+static LPVERSIONED_NODE GetFirstViewNode(LPLIST_VIEW lpView) {
+  return __atomic_load_n(&(lpView->lpList->pHead), __ATOMIC_ACQUIRE);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetNextViewNode function - Gets the node that follows lpNode, or NULL if
+// none of the nodes that follow it can be part of the view.  Nodes are only
+// ever added at the tail, so the versions in which their elements were added
+// increase along the list, and a scan stops at the first node that was added
+// after the view was opened.
+
+static LPVERSIONED_NODE GetNextViewNode(LPLIST_VIEW lpView,
+    LPVERSIONED_NODE lpNode) {
+  LPVERSIONED_NODE lpNext = __atomic_load_n(&(lpNode->pNext),
+      __ATOMIC_ACQUIRE);
+  if (lpNext != NULL && lpNext->nBirth > lpView->nVersion) {
+    return NULL;
+  }
+  return lpNext;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// IsNodeInView function - Determines whether the element of a node is part of
+// the version of the list that a view shows.
+
+static BOOL IsNodeInView(LPLIST_VIEW lpView, LPVERSIONED_NODE lpNode) {
+  return lpNode->nBirth <= lpView->nVersion
+      && lpView->nVersion < __atomic_load_n(&(lpNode->nDeath),
+          __ATOMIC_RELAXED);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// SweepVersionedList function - Walks the list once, marking the elements
+// that match the key, if lpfnCompareFunc is not NULL, as removed in a new
+// version, and unlinking the nodes of elements that were removed in a version
+// that is older than any open view.  Must be called by a writer.  Returns the
+// number of nodes freed, and stores the number of elements removed in
+// *pnRemoved.
+
+static int SweepVersionedList(LPVERSIONED_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareFunc, int* pnRemoved) {
+  uint64_t nNewVersion = lpList->nVersion + 1;
+
+  // Views are opened in order of version, so the oldest view can see
+  // everything that any other view can.  A view that is opened after this
+  // point shows at least the current version, so it cannot see the nodes
+  // that are unlinked below either.
+  pthread_mutex_lock(&(lpList->viewMutex));
+
+  uint64_t nOldestVersion = lpList->pOldestView != NULL
+      ? lpList->pOldestView->nVersion : lpList->nVersion;
+
+  pthread_mutex_unlock(&(lpList->viewMutex));
+
+  int nRemoved = 0;
+  LPVERSIONED_NODE lpUnlinked = NULL;
+  LPVERSIONED_NODE lpPrev = NULL;
+  LPVERSIONED_NODE lpNode = lpList->pHead;
+
+  while (lpNode != NULL) {
+    LPVERSIONED_NODE lpNext = lpNode->pNext;
+
+    if (lpNode->nDeath <= nOldestVersion) {
+      // No open view can see the element; leave lpNode->pNext as it is, for
+      // the sake of any reader that is standing on the node
+      if (lpPrev == NULL) {
+        __atomic_store_n(&(lpList->pHead), lpNext, __ATOMIC_RELEASE);
+      } else {
+        __atomic_store_n(&(lpPrev->pNext), lpNext, __ATOMIC_RELEASE);
+      }
+      if (lpList->pTail == lpNode) {
+        lpList->pTail = lpPrev;
+      }
+
+      lpNode->pNextRetired = lpUnlinked;
+      lpUnlinked = lpNode;
+    } else {
+      if (lpfnCompareFunc != NULL && lpNode->nDeath == VERSIONED_NODE_LIVE
+          && lpfnCompareFunc(pvSearchKey, lpNode->pvData)) {
+        __atomic_store_n(&(lpNode->nDeath), nNewVersion, __ATOMIC_RELAXED);
+        nRemoved++;
+      }
+      lpPrev = lpNode;
+    }
+
+    lpNode = lpNext;
+  }
+
+  if (nRemoved > 0) {
+    __atomic_store_n(&(lpList->nCount), lpList->nCount - nRemoved,
+        __ATOMIC_RELAXED);
+
+    // Publishes the marks made above to the views opened from now on
+    __atomic_store_n(&(lpList->nVersion), nNewVersion, __ATOMIC_RELEASE);
+  }
+
+  *pnRemoved = nRemoved;
+
+  return FreeRetiredNodes(lpList, lpUnlinked);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Publicly-exposed functions
+
+//////////////////////////////////////////////////////////////////////////////
+// AddVersionedElement function
+
+BOOL AddVersionedElement(LPVERSIONED_LIST lpList, void* pvData) {
+  if (lpList == NULL) {
+    return FALSE; // Required parameter
+  }
+
+  LPVERSIONED_NODE lpNew = (LPVERSIONED_NODE) malloc(
+      sizeof(VERSIONED_NODE));
+  if (lpNew == NULL) {
+    fprintf(stderr, FAILED_ALLOC_NEW_NODE);
+    return FALSE;
+  }
+
+  pthread_mutex_lock(&(lpList->writeMutex));
+
+  uint64_t nNewVersion = lpList->nVersion + 1;
+
+  lpNew->pvData = pvData;
+  lpNew->pNext = NULL;
+  lpNew->nBirth = nNewVersion;
+  lpNew->nDeath = VERSIONED_NODE_LIVE;
+  lpNew->nRetired = 0;
+  lpNew->pNextRetired = NULL;
+
+  if (lpList->pTail == NULL) {
+    __atomic_store_n(&(lpList->pHead), lpNew, __ATOMIC_RELEASE);
+  } else {
+    __atomic_store_n(&(lpList->pTail->pNext), lpNew, __ATOMIC_RELEASE);
+  }
+  lpList->pTail = lpNew;
+
+  __atomic_store_n(&(lpList->nCount), lpList->nCount + 1, __ATOMIC_RELAXED);
+  __atomic_store_n(&(lpList->nVersion), nNewVersion, __ATOMIC_RELEASE);
+
+  // Frees what the views that have been closed since the last change were
+  // holding on to
+  FreeRetiredNodes(lpList, NULL);
+
+  pthread_mutex_unlock(&(lpList->writeMutex));
+
+  return TRUE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CloseListView function
+
+void CloseListView(LPPLIST_VIEW lppView) {
+  if (lppView == NULL || *lppView == NULL) {
+    return; // Nothing to do
+  }
+
+  LPLIST_VIEW lpView = *lppView;
+  LPVERSIONED_LIST lpList = lpView->lpList;
+
+  pthread_mutex_lock(&(lpList->viewMutex));
+
+  if (lpView->pPrev == NULL) {
+    lpList->pOldestView = lpView->pNext;
+  } else {
+    lpView->pPrev->pNext = lpView->pNext;
+  }
+  if (lpView->pNext == NULL) {
+    lpList->pNewestView = lpView->pPrev;
+  } else {
+    lpView->pNext->pPrev = lpView->pPrev;
+  }
+
+  pthread_mutex_unlock(&(lpList->viewMutex));
+
+  free(lpView);
+  *lppView = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// CreateVersionedList function
+
+void CreateVersionedList(LPPVERSIONED_LIST lppList,
+    LPDEALLOC_ROUTINE lpfnDeallocFunc) {
+  if (lppList == NULL) {
+    return; // Required parameter
+  }
+
+  *lppList = NULL;
+
+  if (lpfnDeallocFunc == NULL) {
+    return; // Required parameter
+  }
+
+  *lppList = (LPVERSIONED_LIST) malloc(sizeof(VERSIONED_LIST));
+  if (*lppList == NULL) {
+    fprintf(stderr, FAILED_ALLOC_LIST);
+    return;
+  }
+
+  memset(*lppList, 0, sizeof(VERSIONED_LIST));
+
+  (*lppList)->lpfnDeallocFunc = lpfnDeallocFunc;
+  (*lppList)->nNextSequence = 1;  // Stamps of zero mean not retired
+
+  pthread_mutex_init(&((*lppList)->writeMutex), NULL);
+  pthread_mutex_init(&((*lppList)->viewMutex), NULL);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DestroyVersionedList function
+
+void DestroyVersionedList(LPPVERSIONED_LIST lppList) {
+  if (lppList == NULL || *lppList == NULL) {
+    return; // Nothing to do
+  }
+
+  LPVERSIONED_LIST lpList = *lppList;
+
+  // Elements that were removed, but not yet unlinked, still own their data
+  LPVERSIONED_NODE lpNode = lpList->pHead;
+  while (lpNode != NULL) {
+    LPVERSIONED_NODE lpNext = lpNode->pNext;
+    lpList->lpfnDeallocFunc(lpNode->pvData);
+    free(lpNode);
+    lpNode = lpNext;
+  }
+
+  lpNode = lpList->pRetired;
+  while (lpNode != NULL) {
+    LPVERSIONED_NODE lpNext = lpNode->pNextRetired;
+    lpList->lpfnDeallocFunc(lpNode->pvData);
+    free(lpNode);
+    lpNode = lpNext;
+  }
+
+  pthread_mutex_destroy(&(lpList->writeMutex));
+  pthread_mutex_destroy(&(lpList->viewMutex));
+
+  free(lpList);
+  *lppList = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// DoForEachViewElement function
+
+void DoForEachViewElement(LPLIST_VIEW lpView, LPACTION_ROUTINE lpfnAction) {
+  if (lpView == NULL || lpfnAction == NULL) {
+    return; // Required parameters
+  }
+
+  for (LPVERSIONED_NODE lpNode = GetFirstViewNode(lpView); lpNode != NULL;
+      lpNode = GetNextViewNode(lpView, lpNode)) {
+    if (IsNodeInView(lpView, lpNode)) {
+      lpfnAction(lpNode->pvData);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindViewElement function
+
+void* FindViewElement(LPLIST_VIEW lpView, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompare) {
+  if (lpView == NULL || lpfnCompare == NULL) {
+    return NULL; // Required parameters
+  }
+
+  for (LPVERSIONED_NODE lpNode = GetFirstViewNode(lpView); lpNode != NULL;
+      lpNode = GetNextViewNode(lpView, lpNode)) {
+    if (IsNodeInView(lpView, lpNode)
+        && lpfnCompare(pvSearchKey, lpNode->pvData)) {
+      return lpNode->pvData;
+    }
+  }
+
+  return NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FindViewElementWhere function
+
+void* FindViewElementWhere(LPLIST_VIEW lpView,
+    LPPREDICATE_ROUTINE lpfnPredicate) {
+  if (lpView == NULL || lpfnPredicate == NULL) {
+    return NULL; // Required parameters
+  }
+
+  for (LPVERSIONED_NODE lpNode = GetFirstViewNode(lpView); lpNode != NULL;
+      lpNode = GetNextViewNode(lpView, lpNode)) {
+    if (IsNodeInView(lpView, lpNode) && lpfnPredicate(lpNode->pvData)) {
+      return lpNode->pvData;
+    }
+  }
+
+  return NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetVersionedElementCount function
+
+int GetVersionedElementCount(LPVERSIONED_LIST lpList) {
+  if (lpList == NULL) {
+    return 0; // Required parameter
+  }
+
+  return __atomic_load_n(&(lpList->nCount), __ATOMIC_RELAXED);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// GetViewElementCount function
+
+int GetViewElementCount(LPLIST_VIEW lpView) {
+  if (lpView == NULL) {
+    return 0; // Required parameter
+  }
+
+  int nCount = 0;
+
+  for (LPVERSIONED_NODE lpNode = GetFirstViewNode(lpView); lpNode != NULL;
+      lpNode = GetNextViewNode(lpView, lpNode)) {
+    if (IsNodeInView(lpView, lpNode)) {
+      nCount++;
+    }
+  }
+
+  return nCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// OpenListView function
+
+void OpenListView(LPVERSIONED_LIST lpList, LPPLIST_VIEW lppView) {
+  if (lppView == NULL) {
+    return; // Required parameter
+  }
+
+  *lppView = NULL;
+
+  if (lpList == NULL) {
+    return; // Required parameter
+  }
+
+  LPLIST_VIEW lpView = (LPLIST_VIEW) malloc(sizeof(LIST_VIEW));
+  if (lpView == NULL) {
+    fprintf(stderr, FAILED_ALLOC_LIST_VIEW);
+    return;
+  }
+
+  lpView->lpList = lpList;
+  lpView->pNext = NULL;
+
+  pthread_mutex_lock(&(lpList->viewMutex));
+
+  // Reading the version under the lock keeps the views in order of version,
+  // as well as of sequence
+  lpView->nVersion = __atomic_load_n(&(lpList->nVersion), __ATOMIC_ACQUIRE);
+  lpView->nSequence = lpList->nNextSequence++;
+
+  lpView->pPrev = lpList->pNewestView;
+  if (lpList->pNewestView == NULL) {
+    lpList->pOldestView = lpView;
+  } else {
+    lpList->pNewestView->pNext = lpView;
+  }
+  lpList->pNewestView = lpView;
+
+  pthread_mutex_unlock(&(lpList->viewMutex));
+
+  *lppView = lpView;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ReclaimVersionedList function
+
+int ReclaimVersionedList(LPVERSIONED_LIST lpList) {
+  if (lpList == NULL) {
+    return 0; // Required parameter
+  }
+
+  int nRemoved = 0;
+
+  pthread_mutex_lock(&(lpList->writeMutex));
+
+  int nFreed = SweepVersionedList(lpList, NULL, NULL, &nRemoved);
+
+  pthread_mutex_unlock(&(lpList->writeMutex));
+
+  return nFreed;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// RemoveVersionedElementWhere function
+
+int RemoveVersionedElementWhere(LPVERSIONED_LIST lpList, void* pvSearchKey,
+    LPCOMPARE_ROUTINE lpfnCompareFunc) {
+  if (lpList == NULL || lpfnCompareFunc == NULL) {
+    return 0; // Required parameters
+  }
+
+  int nRemoved = 0;
+
+  pthread_mutex_lock(&(lpList->writeMutex));
+
+  SweepVersionedList(lpList, pvSearchKey, lpfnCompareFunc, &nRemoved);
+
+  pthread_mutex_unlock(&(lpList->writeMutex));
+
+  return nRemoved;
+}